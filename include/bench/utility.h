@@ -0,0 +1,48 @@
+#ifndef KISMET_BENCH_UTILITY_H
+#define KISMET_BENCH_UTILITY_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+
+namespace kismet
+{
+
+namespace bench
+{
+
+// number of values processed per benchmark iteration, large enough to hide the
+// loop overhead and small enough to stay in the L1 cache
+const std::size_t batch_size = 256;
+
+// Report the time per op, e.g. "time/op=12.5ns", and FLOP/s, where an op is one call
+// of the benchmarked function and flops is the number of floating point operations of one op
+inline void set_counters(benchmark::State& state, std::size_t ops_per_iteration, double flops = 0)
+{
+    double ops = static_cast<double>(ops_per_iteration);
+    state.counters["time/op"] = benchmark::Counter(ops,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    if (flops > 0)
+    {
+        state.counters["FLOP/s"] = benchmark::Counter(ops * flops,
+            benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::OneK::kIs1000);
+    }
+}
+
+// fill [first, last) with uniform random values in [lo, hi)
+template<typename T, typename ForwardIt>
+void fill_random(ForwardIt first, ForwardIt last, T lo, T hi, std::mt19937& mt)
+{
+    std::uniform_real_distribution<T> dis(lo, hi);
+    for (; first != last; ++first)
+    {
+        *first = dis(mt);
+    }
+}
+
+} // namespace bench
+
+} // namespace kismet
+
+#endif // KISMET_BENCH_UTILITY_H
@@ -0,0 +1,33 @@
+#ifndef KISMET_FUZZY_BATCH_H
+#define KISMET_FUZZY_BATCH_H
+
+#include <cstddef>
+#include "kismet/core/cpu.h"
+
+namespace kismet
+{
+namespace fuzzy
+{
+
+/**
+ * A kernel calculating the degrees of membership of n inputs in the trapezoid set m1, m2, m3, m4
+ */
+using dom_trapezoid_kernel = void (*)(float m1, float m2, float m3, float m4,
+                                      float const* input, float* dom, std::size_t n);
+
+/**
+ * Calculate the degrees of membership of n inputs in the trapezoid set m1 <= m2 <= m3 <= m4,
+ * dom[k] is the same as fuzzy_set_trapezoid::get_dom(input[k]). A triangle set has m2 == m3.
+ * The kernel is selected for active_simd_level() on the first call.
+ */
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n);
+
+/**
+ * Return the kernel compiled for level, or null if the build or the CPU does not support it
+ */
+dom_trapezoid_kernel find_dom_trapezoid_kernel(simd_level level);
+
+} // namespace fuzzy
+} // namespace kismet
+
+#endif // KISMET_FUZZY_BATCH_H
@@ -0,0 +1,123 @@
+#ifndef KISMET_CORE_ALIGNED_ALLOCATOR_H
+#define KISMET_CORE_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace kismet
+{
+
+namespace detail
+{
+
+// Allocate size bytes aligned to align, which must be a power of 2.
+// The pointer returned by malloc is stored right before the aligned block.
+inline void* aligned_malloc(std::size_t size, std::size_t align)
+{
+    if (size > (std::numeric_limits<std::size_t>::max)() - align - sizeof(void*))
+    {
+        return nullptr;
+    }
+
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw)
+    {
+        return nullptr;
+    }
+
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* p = reinterpret_cast<void*>((start + align - 1) & ~std::uintptr_t(align - 1));
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+}
+
+inline void aligned_free(void* p)
+{
+    if (p)
+    {
+        std::free(static_cast<void**>(p)[-1]);
+    }
+}
+
+} // namespace detail
+
+/// An allocator which returns memory aligned to Align bytes,
+/// it can be used in place of std::allocator for standard containers, e.g.
+/// to hold over-aligned types, which operator new does not support before C++17.
+template<typename T, std::size_t Align = alignof(T)>
+class aligned_allocator
+{
+    static_assert(Align > 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+    static_assert(Align >= alignof(T), "Align must not be less than the alignment of T");
+public:
+    using value_type      = T;
+    using pointer         = T*;
+    using const_pointer   = T const*;
+    using reference       = T&;
+    using const_reference = T const&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    enum { alignment = Align };
+
+    template<typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() = default;
+
+    template<typename U>
+    aligned_allocator(aligned_allocator<U, Align> const&) noexcept
+    {
+    }
+
+    T* allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+
+        void* p = detail::aligned_malloc(n * sizeof(T), Align);
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_type) noexcept
+    {
+        detail::aligned_free(p);
+    }
+
+    size_type max_size() const noexcept
+    {
+        return (std::numeric_limits<size_type>::max)() / sizeof(T);
+    }
+};
+
+template<typename T, typename U, std::size_t Align>
+inline bool operator ==(aligned_allocator<T, Align> const&, aligned_allocator<U, Align> const&)
+{
+    return true;
+}
+
+template<typename T, typename U, std::size_t Align>
+inline bool operator !=(aligned_allocator<T, Align> const&, aligned_allocator<U, Align> const&)
+{
+    return false;
+}
+
+} // namespace kismet
+
+#endif // KISMET_CORE_ALIGNED_ALLOCATOR_H
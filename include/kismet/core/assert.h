@@ -5,7 +5,7 @@
 #include <cassert>
 
 #define KISMET_ASSERT assert
-#define KISMET_ASSERT_ALIGN(p, a) KISMET_ASSERT((reinterpret_cast<std::uintptr_t>(p) & ~a) == 0)
+#define KISMET_ASSERT_ALIGN(p, a) KISMET_ASSERT((reinterpret_cast<std::uintptr_t>(p) & ((a) - 1)) == 0)
 
 #endif // KISMET_CORE_ASSERT_H
 
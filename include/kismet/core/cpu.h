@@ -0,0 +1,141 @@
+#ifndef KISMET_CORE_CPU_H
+#define KISMET_CORE_CPU_H
+
+#include <cstdlib>
+#include <cstring>
+
+#include "kismet/config.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define KISMET_X86
+#  if defined(KISMET_MSC)
+#    include <intrin.h>
+#  endif
+#endif
+
+namespace kismet
+{
+
+/// The instruction sets the batch kernels are compiled for, in increasing order.
+/// The avx2 level requires FMA, the avx512 level requires AVX-512 F, VL, DQ and BW.
+enum class simd_level
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512
+};
+
+/// Return the name of level, which is also the value of KISMET_SIMD that selects it
+inline char const* simd_level_name(simd_level level)
+{
+    switch (level)
+    {
+    case simd_level::sse2:
+        return "sse2";
+    case simd_level::avx2:
+        return "avx2";
+    case simd_level::avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+/// Parse the name of a level, return false if the name is unknown
+inline bool parse_simd_level(char const* name, simd_level& level)
+{
+    const simd_level levels[] = { simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512 };
+    for (simd_level l : levels)
+    {
+        if (name != nullptr && std::strcmp(name, simd_level_name(l)) == 0)
+        {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Return the highest level supported by the CPU and the operating system
+inline simd_level detect_simd_level()
+{
+#if defined(KISMET_X86) && defined(KISMET_GCC)
+    // the builtins also check that the OS saves the AVX registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw"))
+    {
+        return simd_level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return simd_level::avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return simd_level::sse2;
+    }
+    return simd_level::scalar;
+#elif defined(KISMET_X86) && defined(KISMET_MSC)
+    int info[4];
+    __cpuid(info, 0);
+    int ids = info[0];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    // the OS saves the YMM registers, and the ZMM and opmask registers
+    bool ymm = (xcr0 & 0x6) == 0x6;
+    bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+    bool avx2 = false;
+    bool avx512 = false;
+    if (ids >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        // F, DQ, BW, VL
+        const int avx512_bits = (1 << 16) | (1 << 17) | (1 << 30) | (1 << 31);
+        avx512 = (info[1] & avx512_bits) == avx512_bits;
+    }
+
+    if (avx512 && avx2 && fma && zmm)
+    {
+        return simd_level::avx512;
+    }
+    if (avx2 && fma && ymm)
+    {
+        return simd_level::avx2;
+    }
+    return sse2 ? simd_level::sse2 : simd_level::scalar;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+/// Apply the override name to the detected level. The result is the named level
+/// if it is not higher than detected, otherwise detected; an unknown or null name is ignored.
+inline simd_level override_simd_level(simd_level detected, char const* name)
+{
+    simd_level level;
+    if (parse_simd_level(name, level) && level < detected)
+    {
+        return level;
+    }
+    return detected;
+}
+
+/// Return the level the batch kernels are selected for, which is the detected level
+/// lowered by the environment variable KISMET_SIMD, e.g. KISMET_SIMD=scalar for testing.
+/// Both are read once, on the first call.
+inline simd_level active_simd_level()
+{
+    static const simd_level level = override_simd_level(detect_simd_level(), std::getenv("KISMET_SIMD"));
+    return level;
+}
+
+} // namespace kismet
+
+#endif // KISMET_CORE_CPU_H
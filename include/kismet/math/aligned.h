@@ -0,0 +1,84 @@
+#ifndef KISMET_MATH_ALIGNED_H
+#define KISMET_MATH_ALIGNED_H
+
+#include <cstddef>
+
+#include "kismet/core/aligned_allocator.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/vector.h"
+
+namespace kismet
+{
+namespace math
+{
+
+namespace detail
+{
+
+// the smallest power of 2 which is not less than n
+constexpr std::size_t ceil_pow2(std::size_t n, std::size_t p = 1)
+{
+    return p >= n ? p : ceil_pow2(n, p * 2);
+}
+
+// Default alignment of aligned<V>, the size of V rounded up to a power of 2,
+// capped to the width of an AVX register
+template<typename V>
+struct simd_alignment
+{
+    static constexpr std::size_t natural = ceil_pow2(sizeof(V)) < 32 ? ceil_pow2(sizeof(V)) : 32;
+    static constexpr std::size_t value = natural < alignof(V) ? alignof(V) : natural;
+};
+
+} // namespace detail
+
+/// Opt-in storage policy which over-aligns a vector or matrix type V to Align bytes.
+/// The size is rounded up to a multiple of Align, so vector3<float> is padded to
+/// 4 lanes (16 bytes) and vector3<double> to 4 lanes (32 bytes), which allows aligned
+/// SIMD loads of whole elements. The padding lanes have unspecified values.
+/// aligned<V> converts to and from V, arithmetic operators of V return V.
+/// Before C++17 operator new does not honor alignment above alignof(std::max_align_t),
+/// use aligned_allocator for containers of aligned types.
+template<typename V, std::size_t Align = detail::simd_alignment<V>::value>
+struct alignas(Align) aligned : V
+{
+    static_assert(Align >= alignof(V), "Align must not be less than the alignment of V");
+
+    using base_type = V;
+
+    using V::V;
+
+    aligned() = default;
+
+    aligned(V const& v)
+        : V(v)
+    {
+    }
+
+    aligned& operator =(V const& v)
+    {
+        V::operator =(v);
+        return *this;
+    }
+};
+
+template<typename T>
+using aligned_vector3 = aligned<vector3<T>>;
+
+template<typename T>
+using aligned_vector4 = aligned<vector4<T>>;
+
+template<typename T>
+using aligned_matrix44 = aligned<matrix44<T>>;
+
+using aligned_vector3f = aligned_vector3<float>;
+using aligned_vector4f = aligned_vector4<float>;
+using aligned_matrix44f = aligned_matrix44<float>;
+
+using aligned_vector3d = aligned_vector3<double>;
+using aligned_vector4d = aligned_vector4<double>;
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_ALIGNED_H
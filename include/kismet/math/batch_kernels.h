@@ -0,0 +1,61 @@
+#ifndef KISMET_MATH_BATCH_KERNELS_H
+#define KISMET_MATH_BATCH_KERNELS_H
+
+#include "kismet/core/cpu.h"
+#include "kismet/math/matrix_batch.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// The hot stream and batch kernels compiled for one instruction set.
+/// Every kernel has the semantics of the template of the same name, the results of
+/// different levels may differ in rounding only.
+template<typename T>
+struct batch_kernels
+{
+    using vector3_stream = vector_stream<T, 3>;
+
+    simd_level level;
+
+    void (*dot)(vector3_stream const& a, vector3_stream const& b, T* out);
+    void (*cross)(vector3_stream const& a, vector3_stream const& b, vector3_stream& out);
+    bool (*normalize)(vector3_stream const& v, vector3_stream& out, bool* ok, T tolerance);
+
+    void (*rotate)(quaternion_stream<T> const& q, vector3_stream const& v, vector3_stream& out);
+    void (*multiply)(quaternion_stream<T> const& a, quaternion_stream<T> const& b, quaternion_stream<T>& out);
+    void (*slerp)(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T const* t,
+                  quaternion_stream<T>& out);
+
+    void (*quat_from_euler_yxz)(vector3_stream const& e, quaternion_stream<T>& out);
+    void (*matrix_rotate)(quaternion_stream<T> const& q, matrix_batch<T, 4, 4>& out);
+    void (*matrix_to_quat)(matrix_batch<T, 4, 4> const& m, quaternion_stream<T>& out);
+
+    bool (*solve_partial_pivoting)(matrix_batch<T, 4, 4> const& a, matrix_batch<T, 4, 1> const& b,
+                                   matrix_batch<T, 4, 1>& x, bool* ok, T tolerance);
+
+    void (*eigen_decompose_symmetric)(matrix_batch<T, 3, 3> const& a, vector3_stream& values,
+                                      matrix_batch<T, 3, 3>& vectors);
+    void (*svd_decompose)(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& u, vector3_stream& sigma,
+                          matrix_batch<T, 3, 3>& v);
+    void (*polar_decompose)(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& r, matrix_batch<T, 3, 3>& s);
+};
+
+/// Return the kernels of the highest level which is compiled in and not above
+/// active_simd_level(). The CPU is detected and the table is bound on the first call.
+/// T is float or double.
+template<typename T>
+batch_kernels<T> const& get_batch_kernels();
+
+/// Return the kernels compiled for level, or null if the build or the CPU does not support it.
+/// T is float or double.
+template<typename T>
+batch_kernels<T> const* find_batch_kernels(simd_level level);
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_BATCH_KERNELS_H
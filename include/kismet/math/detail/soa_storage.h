@@ -0,0 +1,124 @@
+#ifndef KISMET_MATH_DETAIL_SOA_STORAGE_H
+#define KISMET_MATH_DETAIL_SOA_STORAGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "kismet/core/aligned_allocator.h"
+#include "kismet/core/assert.h"
+
+namespace kismet
+{
+namespace math
+{
+namespace detail
+{
+
+// Size in bytes every array of a soa_storage is padded to, which is
+// wide enough for the widest SIMD register we target.
+constexpr std::size_t soa_padding = 64;
+
+// Number of elements of type T in the padding
+template<typename T>
+struct soa_lanes
+{
+    enum { value = soa_padding / sizeof(T) > 0 ? soa_padding / sizeof(T) : 1 };
+};
+
+// Zero the padding [size, stride) of an array of a soa_storage. Kernels which process
+// whole lanes call it on their outputs when the padding lanes of the inputs don't map
+// to zero, e.g. a rotation from zero angles is the identity.
+template<typename T>
+inline void clear_padding(T* a, std::size_t size, std::size_t stride)
+{
+    std::fill(a + size, a + stride, T(0));
+}
+
+// Storage of C arrays which have the same number of elements, the arrays are
+// laid out one after another. Every array is padded to a multiple of soa_lanes<T>
+// elements, the padding elements are always zero, so that kernels are free to
+// process whole lanes. Every array starts on a soa_padding byte boundary.
+template<typename T, std::size_t C>
+class soa_storage
+{
+    static_assert(C > 0, "C must be positive");
+public:
+    using size_type = std::size_t;
+    using allocator_type = aligned_allocator<T, soa_padding>;
+
+    soa_storage()
+        : m_size(0)
+        , m_stride(0)
+    {
+    }
+
+    explicit soa_storage(size_type n)
+        : soa_storage()
+    {
+        resize(n);
+    }
+
+    // Resize all arrays, existing elements are preserved, new elements are zero
+    void resize(size_type n)
+    {
+        size_type stride = (n + soa_lanes<T>::value - 1) / soa_lanes<T>::value * soa_lanes<T>::value;
+        if (stride != m_stride)
+        {
+            std::vector<T, allocator_type> data(stride * C, T(0));
+            size_type count = (std::min)(n, m_size);
+            for (size_type c = 0; c < C; ++c)
+            {
+                std::copy_n(m_data.data() + c * m_stride, count, data.data() + c * stride);
+            }
+            m_data.swap(data);
+            m_stride = stride;
+        }
+        else if (n < m_size)
+        {
+            // restore the zero padding
+            for (size_type c = 0; c < C; ++c)
+            {
+                std::fill(component(c) + n, component(c) + m_size, T(0));
+            }
+        }
+        m_size = n;
+    }
+
+    // Return the number of elements of each array
+    size_type size() const { return m_size; }
+
+    // Return the distance between the starts of two adjacent arrays
+    size_type stride() const { return m_stride; }
+
+    // Return the start of the c-th array
+    T* component(size_type c)
+    {
+        KISMET_ASSERT(c < C);
+        return m_data.data() + c * m_stride;
+    }
+
+    T const* component(size_type c) const
+    {
+        KISMET_ASSERT(c < C);
+        return m_data.data() + c * m_stride;
+    }
+
+    void swap(soa_storage& rhs)
+    {
+        using std::swap;
+        m_data.swap(rhs.m_data);
+        swap(m_size, rhs.m_size);
+        swap(m_stride, rhs.m_stride);
+    }
+private:
+    std::vector<T, allocator_type> m_data;
+    size_type m_size;
+    size_type m_stride;
+};
+
+} // namespace detail
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_DETAIL_SOA_STORAGE_H
@@ -0,0 +1,395 @@
+#ifndef KISMET_MATH_DETAIL_SYMMETRIC_EIGEN_H
+#define KISMET_MATH_DETAIL_SYMMETRIC_EIGEN_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "kismet/math/matrix.h"
+#include "kismet/math/utility.h"
+
+// The kernels of the symmetric 3x3 eigendecomposition shared by eigen.h and svd.h.
+// A symmetric matrix is passed as its unique elements a00, a11, a22, a01, a02, a12.
+
+namespace kismet
+{
+namespace math
+{
+namespace detail
+{
+
+// The upper bound of the relative residual ||A*v - l*v|| / ||A|| of the closed form
+// eigenpairs, beyond which they are recomputed with Jacobi rotations
+template<typename T>
+inline T eigen_accuracy()
+{
+    return T(256) * std::numeric_limits<T>::epsilon();
+}
+
+// The maximum number of cyclic sweeps of the scalar Jacobi method
+const std::size_t jacobi_max_sweeps = 16;
+
+// The number of cyclic sweeps of the batch Jacobi method, which converges quadratically,
+// enough for the accuracy of T with any input
+template<typename T>
+struct jacobi_sweeps
+{
+    static const std::size_t value = sizeof(T) > 4 ? 6 : 5;
+};
+
+// Annihilate a[p][q] of a symmetric matrix with a Jacobi rotation, r is the third index.
+// The rotation is applied to the columns p and q of v. Without branches, a[p][q] == 0
+// gives the identity rotation, so that batch kernels can run it on every lane.
+template<typename T>
+inline void jacobi_rotate(T& app, T& aqq, T& apq, T& apr, T& aqr,
+                          T& v0p, T& v0q, T& v1p, T& v1q, T& v2p, T& v2q)
+{
+    using std::abs;
+    using std::copysign;
+    using std::sqrt;
+
+    // Drop a[p][q] below the rounding error of the diagonal. Converged elements would
+    // otherwise keep shrinking quadratically into subnormals, which are two orders of
+    // magnitude slower in the fixed sweeps of the batch version.
+    apq *= step(std::numeric_limits<T>::epsilon() * (abs(app) + abs(aqq)), abs(apq));
+
+    // t = tan(theta) of the smaller rotation angle,
+    // the smallest normal keeps 0/0 away when a[p][p] == a[q][q] and a[p][q] == 0
+    T tau = aqq - app;
+    T t = T(2) * apq * copysign(T(1), tau) /
+          (abs(tau) + sqrt(tau * tau + T(4) * apq * apq) + (std::numeric_limits<T>::min)());
+    T c = T(1) / sqrt(T(1) + t * t);
+    T s = t * c;
+
+    app -= t * apq;
+    aqq += t * apq;
+    apq = T(0);
+
+    T pr = apr;
+    T qr = aqr;
+    apr = c * pr - s * qr;
+    aqr = s * pr + c * qr;
+
+    T p0 = v0p, q0 = v0q;
+    T p1 = v1p, q1 = v1q;
+    T p2 = v2p, q2 = v2q;
+    v0p = c * p0 - s * q0;
+    v0q = s * p0 + c * q0;
+    v1p = c * p1 - s * q1;
+    v1q = s * p1 + c * q1;
+    v2p = c * p2 - s * q2;
+    v2q = s * p2 + c * q2;
+}
+
+// one cyclic sweep over the off-diagonal elements,
+// a holds the unique elements a00, a11, a22, a01, a02, a12 and v the rows of V
+template<typename T>
+inline void jacobi_sweep(T (&a)[6], T (&v)[3][3])
+{
+    jacobi_rotate(a[0], a[1], a[3], a[4], a[5], v[0][0], v[0][1], v[1][0], v[1][1], v[2][0], v[2][1]);
+    jacobi_rotate(a[0], a[2], a[4], a[3], a[5], v[0][0], v[0][2], v[1][0], v[1][2], v[2][0], v[2][2]);
+    jacobi_rotate(a[1], a[2], a[5], a[3], a[4], v[0][1], v[0][2], v[1][1], v[1][2], v[2][1], v[2][2]);
+}
+
+// one cyclic sweep over L matrices, element e of the l-th matrix is a[e][l] and v[i][j][l],
+// the lane loops are innermost so that they are vectorized
+template<typename T, std::size_t L>
+inline void jacobi_sweep(T (&a)[6][L], T (&v)[3][3][L])
+{
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        jacobi_rotate(a[0][l], a[1][l], a[3][l], a[4][l], a[5][l],
+                      v[0][0][l], v[0][1][l], v[1][0][l], v[1][1][l], v[2][0][l], v[2][1][l]);
+    }
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        jacobi_rotate(a[0][l], a[2][l], a[4][l], a[3][l], a[5][l],
+                      v[0][0][l], v[0][2][l], v[1][0][l], v[1][2][l], v[2][0][l], v[2][2][l]);
+    }
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        jacobi_rotate(a[1][l], a[2][l], a[5][l], a[3][l], a[4][l],
+                      v[0][1][l], v[0][2][l], v[1][1][l], v[1][2][l], v[2][1][l], v[2][2][l]);
+    }
+}
+
+// sort the eigenvalues in ascending order along with the columns of v, and make v a rotation
+template<typename T>
+inline void sort_eigen(T (&values)[3], T (&v)[3][3])
+{
+    const std::size_t pairs[3][2] = { { 0, 1 }, { 1, 2 }, { 0, 1 } };
+    for (auto const& pair : pairs)
+    {
+        std::size_t i = pair[0];
+        std::size_t j = pair[1];
+        if (values[j] < values[i])
+        {
+            std::swap(values[i], values[j]);
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                std::swap(v[k][i], v[k][j]);
+            }
+        }
+    }
+
+    T det = v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1])
+          - v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0])
+          + v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+    if (det < T(0))
+    {
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            v[k][2] = -v[k][2];
+        }
+    }
+}
+
+// The unit eigenvector of the eigenvalue l as the longest cross product of two rows
+// of A - l*I, which are orthogonal to it. Return false if all cross products vanish,
+// i.e. l is a repeated eigenvalue.
+template<typename T>
+bool eigenvector_of(T const (&a)[6], T l, T (&v)[3])
+{
+    using std::sqrt;
+
+    const T r[3][3] = {
+        { a[0] - l, a[3], a[4] },
+        { a[3], a[1] - l, a[5] },
+        { a[4], a[5], a[2] - l }
+    };
+    const std::size_t pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+    T best(0);
+    std::fill_n(v, 3, T(0));
+    for (auto const& pair : pairs)
+    {
+        T const* x = r[pair[0]];
+        T const* y = r[pair[1]];
+        T c[3] = {
+            x[1] * y[2] - x[2] * y[1],
+            x[2] * y[0] - x[0] * y[2],
+            x[0] * y[1] - x[1] * y[0]
+        };
+        // selects rather than a branch, which mispredicts on random input
+        T n = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+        bool longer = n > best;
+        best = longer ? n : best;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            v[i] = longer ? c[i] : v[i];
+        }
+    }
+
+    if (!(best > (std::numeric_limits<T>::min)()))
+    {
+        return false;
+    }
+
+    T inv = T(1) / sqrt(best);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        v[i] *= inv;
+    }
+    return true;
+}
+
+// The closed form of Smith: the eigenvalues are the roots of the characteristic polynomial
+// in trigonometric form, the eigenvectors of the extreme eigenvalues are cross products
+// and the middle one completes the basis.
+// Return false if the result is not within eigen_accuracy, e.g. for close eigenvalues.
+template<typename T>
+bool eigen_closed_form(T const (&a)[6], T (&values)[3], T (&v)[3][3])
+{
+    using std::acos;
+    using std::cos;
+    using std::sqrt;
+
+    T off = a[3] * a[3] + a[4] * a[4] + a[5] * a[5];
+    T q = (a[0] + a[1] + a[2]) / T(3);
+    T d0 = a[0] - q;
+    T d1 = a[1] - q;
+    T d2 = a[2] - q;
+    T p2 = d0 * d0 + d1 * d1 + d2 * d2 + T(2) * off;
+    T norm = sqrt(p2 + T(3) * q * q + off);
+    if (!(off > (std::numeric_limits<T>::min)()) || !(p2 > (std::numeric_limits<T>::min)()))
+    {
+        // diagonal or a multiple of I, left to Jacobi which handles it exactly
+        return false;
+    }
+
+    // B = (A - q*I) / p, the eigenvalues of B are 2*cos(phi + 2k*pi/3)
+    T p = sqrt(p2 / T(6));
+    T inv_p = T(1) / p;
+    T b0 = d0 * inv_p;
+    T b1 = d1 * inv_p;
+    T b2 = d2 * inv_p;
+    T b01 = a[3] * inv_p;
+    T b02 = a[4] * inv_p;
+    T b12 = a[5] * inv_p;
+    T half_det = T(0.5) * (b0 * (b1 * b2 - b12 * b12) - b01 * (b01 * b2 - b12 * b02) + b02 * (b01 * b12 - b1 * b02));
+    half_det = (std::min)((std::max)(half_det, T(-1)), T(1));
+
+    const T two_pi_3 = T(2.09439510239319549231);
+    T phi = acos(half_det) / T(3);
+    T largest = q + T(2) * p * cos(phi);
+    T smallest = q + T(2) * p * cos(phi + two_pi_3);
+
+    T v0[3];
+    T v2[3];
+    if (!eigenvector_of(a, smallest, v0) || !eigenvector_of(a, largest, v2))
+    {
+        return false;
+    }
+
+    T accuracy = eigen_accuracy<T>();
+    T orth = v0[0] * v2[0] + v0[1] * v2[1] + v0[2] * v2[2];
+    if (!(std::abs(orth) <= accuracy))
+    {
+        return false;
+    }
+
+    // v1 = v2 x v0 makes (v0, v1, v2) right handed
+    T v1[3] = {
+        v2[1] * v0[2] - v2[2] * v0[1],
+        v2[2] * v0[0] - v2[0] * v0[2],
+        v2[0] * v0[1] - v2[1] * v0[0]
+    };
+
+    T const* cols[3] = { v0, v1, v2 };
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+        // the Rayleigh quotient is more accurate than the root
+        T const* x = cols[j];
+        T ax[3] = {
+            a[0] * x[0] + a[3] * x[1] + a[4] * x[2],
+            a[3] * x[0] + a[1] * x[1] + a[5] * x[2],
+            a[4] * x[0] + a[5] * x[1] + a[2] * x[2]
+        };
+        T l = ax[0] * x[0] + ax[1] * x[1] + ax[2] * x[2];
+
+        T res(0);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            T e = ax[i] - l * x[i];
+            res += e * e;
+            v[i][j] = x[i];
+        }
+        if (!(sqrt(res) <= accuracy * norm))
+        {
+            return false;
+        }
+        values[j] = l;
+    }
+    return true;
+}
+
+// Cyclic Jacobi until the off-diagonal elements are negligible.
+// Return false if it does not converge within max_sweeps.
+template<typename T>
+bool eigen_jacobi(T const (&a)[6], T (&values)[3], T (&v)[3][3], std::size_t max_sweeps)
+{
+    T d[6];
+    std::copy_n(a, 6, d);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            v[i][j] = i == j ? T(1) : T(0);
+        }
+    }
+
+    T eps = std::numeric_limits<T>::epsilon();
+    T norm = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] + T(2) * (d[3] * d[3] + d[4] * d[4] + d[5] * d[5]);
+    bool converged = false;
+    for (std::size_t sweep = 0; sweep <= max_sweeps; ++sweep)
+    {
+        T off = d[3] * d[3] + d[4] * d[4] + d[5] * d[5];
+        if (off <= eps * eps * norm)
+        {
+            converged = true;
+            break;
+        }
+        if (sweep < max_sweeps)
+        {
+            jacobi_sweep(d, v);
+        }
+    }
+
+    values[0] = d[0];
+    values[1] = d[1];
+    values[2] = d[2];
+    sort_eigen(values, v);
+    return converged;
+}
+
+template<typename T>
+inline void unique_elements(matrix<T, 3, 3> const& a, T (&e)[6])
+{
+    e[0] = a[0][0];
+    e[1] = a[1][1];
+    e[2] = a[2][2];
+    e[3] = a[1][0];
+    e[4] = a[2][0];
+    e[5] = a[2][1];
+}
+
+// Eigendecompose L symmetric matrices with a fixed number of Jacobi sweeps and sort them
+// without branches, d holds the unique elements as in jacobi_sweep and is left with
+// the eigenvalues in d[0], d[1] and d[2], v is set to the eigenvectors
+template<typename T, std::size_t L>
+inline void jacobi_eigen(T (&d)[6][L], T (&v)[3][3][L])
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            std::fill_n(v[i][j], L, i == j ? T(1) : T(0));
+        }
+    }
+
+    for (std::size_t s = 0; s < jacobi_sweeps<T>::value; ++s)
+    {
+        jacobi_sweep(d, v);
+    }
+
+    // sorting network of compare-exchanges, m is 1 if the pair is out of order
+    const std::size_t pairs[3][2] = { { 0, 1 }, { 1, 2 }, { 0, 1 } };
+    for (auto const& pair : pairs)
+    {
+        std::size_t i = pair[0];
+        std::size_t j = pair[1];
+        for (std::size_t l = 0; l < L; ++l)
+        {
+            T m = T(1) - step(d[i][l], d[j][l]);
+            T di = m * (d[j][l] - d[i][l]);
+            d[i][l] += di;
+            d[j][l] -= di;
+            for (std::size_t r = 0; r < 3; ++r)
+            {
+                T vi = m * (v[r][j][l] - v[r][i][l]);
+                v[r][i][l] += vi;
+                v[r][j][l] -= vi;
+            }
+        }
+    }
+
+    // flip the last column of a reflection
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        T det = v[0][0][l] * (v[1][1][l] * v[2][2][l] - v[1][2][l] * v[2][1][l])
+              - v[0][1][l] * (v[1][0][l] * v[2][2][l] - v[1][2][l] * v[2][0][l])
+              + v[0][2][l] * (v[1][0][l] * v[2][1][l] - v[1][1][l] * v[2][0][l]);
+        T sign = std::copysign(T(1), det);
+        v[0][2][l] *= sign;
+        v[1][2][l] *= sign;
+        v[2][2][l] *= sign;
+    }
+}
+
+} // namespace detail
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_DETAIL_SYMMETRIC_EIGEN_H
@@ -0,0 +1,442 @@
+#ifndef KISMET_MATH_DUAL_QUATERNION_H
+#define KISMET_MATH_DUAL_QUATERNION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/math_trait.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/quaternion.h"
+#include "kismet/math/vector.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A dual quaternion real + eps * dual, where eps^2 = 0.
+/// A unit dual quaternion represents a rigid transform with 8 numbers, the rotation is
+/// the real part and the translation t is encoded as dual = 0.5 * (0, t) * real.
+template<typename T>
+class dual_quaternion
+{
+public:
+    // default construction, not initialized
+    dual_quaternion() = default;
+
+    dual_quaternion(quaternion<T> const& real, quaternion<T> const& dual)
+        : m_real(real)
+        , m_dual(dual)
+    {
+    }
+
+    // create a rigid transform which rotates by the unit quaternion r, then translates by t
+    dual_quaternion(quaternion<T> const& r, vector3<T> const& t)
+        : m_real(r)
+        , m_dual(T(0.5) * (quaternion<T>(T(0), t.x(), t.y(), t.z()) * r))
+    {
+    }
+
+    quaternion<T>& real() { return m_real; }
+    quaternion<T>& dual() { return m_dual; }
+
+    quaternion<T> const& real() const { return m_real; }
+    quaternion<T> const& dual() const { return m_dual; }
+
+    // return the rotation of a unit dual quaternion
+    quaternion<T> const& rotation() const { return m_real; }
+
+    // return the translation of a unit dual quaternion, the vector part of 2 * dual * conjugate(real)
+    vector3<T> translation() const
+    {
+        quaternion<T> const& r = m_real;
+        quaternion<T> const& d = m_dual;
+        return vector3<T>(
+            T(2) * (r.w() * d.x() - d.w() * r.x() + r.y() * d.z() - r.z() * d.y()),
+            T(2) * (r.w() * d.y() - d.w() * r.y() + r.z() * d.x() - r.x() * d.z()),
+            T(2) * (r.w() * d.z() - d.w() * r.z() + r.x() * d.y() - r.y() * d.x()));
+    }
+
+    // Normalize to a unit dual quaternion, i.e. |real| = 1 and dot(real, dual) = 0.
+    // return false if the real part is zero
+    bool normalize(T tolerance = math_trait<T>::zero_tolerance())
+    {
+        T len = m_real.mag();
+        if (is_zero(len, tolerance))
+        {
+            return false;
+        }
+
+        T inv_len = math::invert(len);
+        m_real *= inv_len;
+        m_dual *= inv_len;
+        m_dual -= m_real.dot(m_dual) * m_real;
+        return true;
+    }
+
+    // right multiply a dual quaternion, i.e. *this = *this * rhs,
+    // which applies rhs first as a transform
+    dual_quaternion& operator *=(dual_quaternion const& rhs)
+    {
+        m_dual = m_real * rhs.m_dual + m_dual * rhs.m_real;
+        m_real *= rhs.m_real;
+        return *this;
+    }
+
+    dual_quaternion& operator +=(dual_quaternion const& rhs)
+    {
+        m_real += rhs.m_real;
+        m_dual += rhs.m_dual;
+        return *this;
+    }
+
+    dual_quaternion& operator *=(T k)
+    {
+        m_real *= k;
+        m_dual *= k;
+        return *this;
+    }
+
+    // The identity transform
+    static dual_quaternion const identity;
+private:
+    quaternion<T> m_real;
+    quaternion<T> m_dual;
+};
+
+template<typename T>
+dual_quaternion<T> const dual_quaternion<T>::identity(quaternion<T>::identity, quaternion<T>(T(0), T(0), T(0), T(0)));
+
+// return the quaternion conjugate of both parts, which is the inverse of a unit dual quaternion
+template<typename T>
+inline dual_quaternion<T> conjugate(dual_quaternion<T> const& dq)
+{
+    return dual_quaternion<T>(conjugate(dq.real()), conjugate(dq.dual()));
+}
+
+template<typename T>
+inline dual_quaternion<T> operator *(dual_quaternion<T> lhs, dual_quaternion<T> const& rhs)
+{
+    return lhs *= rhs;
+}
+
+template<typename T>
+inline dual_quaternion<T> operator +(dual_quaternion<T> lhs, dual_quaternion<T> const& rhs)
+{
+    return lhs += rhs;
+}
+
+template<typename T>
+inline dual_quaternion<T> operator *(T k, dual_quaternion<T> rhs)
+{
+    return rhs *= k;
+}
+
+namespace detail
+{
+
+// rotate v by the unit quaternion (w, x, y, z) and add the translation encoded by
+// the dual part (dw, dx, dy, dz), the real part must be unit
+template<typename T>
+inline void transform_point(T w, T x, T y, T z, T dw, T dx, T dy, T dz, T& vx, T& vy, T& vz)
+{
+    // v' = v + 2w(q x v) + 2q x (q x v)
+    T cx = y * vz - z * vy;
+    T cy = z * vx - x * vz;
+    T cz = x * vy - y * vx;
+    T rx = vx + T(2) * (w * cx + y * cz - z * cy);
+    T ry = vy + T(2) * (w * cy + z * cx - x * cz);
+    T rz = vz + T(2) * (w * cz + x * cy - y * cx);
+
+    // t = 2 * (w * d.xyz - dw * q.xyz + q.xyz x d.xyz)
+    vx = rx + T(2) * (w * dx - dw * x + y * dz - z * dy);
+    vy = ry + T(2) * (w * dy - dw * y + z * dx - x * dz);
+    vz = rz + T(2) * (w * dz - dw * z + x * dy - y * dx);
+}
+
+} // namespace detail
+
+/// Transform the point v by the unit dual quaternion dq
+template<typename T>
+inline vector3<T> operator *(dual_quaternion<T> const& dq, vector3<T> const& v)
+{
+    KISMET_ASSERT(approx(squared_mag(dq.real()), T(1.0)));
+
+    quaternion<T> const& r = dq.real();
+    quaternion<T> const& d = dq.dual();
+    vector3<T> res(v);
+    detail::transform_point(r.w(), r.x(), r.y(), r.z(), d.w(), d.x(), d.y(), d.z(), res.x(), res.y(), res.z());
+    return res;
+}
+
+/// Transform the direction v by the unit dual quaternion dq, i.e. rotate only
+template<typename T>
+inline vector3<T> transform_vector(dual_quaternion<T> const& dq, vector3<T> const& v)
+{
+    return dq.real() * v;
+}
+
+/// Convert a unit dual quaternion to a rigid transform matrix
+template<typename T>
+matrix44<T> dual_quat_to_matrix(dual_quaternion<T> const& dq)
+{
+    quaternion<T> const& q = dq.real();
+    vector3<T> t = dq.translation();
+
+    T xx = q.x() * q.x();
+    T yy = q.y() * q.y();
+    T zz = q.z() * q.z();
+    T xy = q.x() * q.y();
+    T xz = q.x() * q.z();
+    T yz = q.y() * q.z();
+    T wx = q.w() * q.x();
+    T wy = q.w() * q.y();
+    T wz = q.w() * q.z();
+
+    matrix44<T> res;
+    res[0][0] = T(1) - T(2) * (yy + zz);
+    res[0][1] = T(2) * (xy - wz);
+    res[0][2] = T(2) * (xz + wy);
+    res[0][3] = t.x();
+
+    res[1][0] = T(2) * (xy + wz);
+    res[1][1] = T(1) - T(2) * (xx + zz);
+    res[1][2] = T(2) * (yz - wx);
+    res[1][3] = t.y();
+
+    res[2][0] = T(2) * (xz - wy);
+    res[2][1] = T(2) * (yz + wx);
+    res[2][2] = T(1) - T(2) * (xx + yy);
+    res[2][3] = t.z();
+
+    res[3][0] = res[3][1] = res[3][2] = T(0);
+    res[3][3] = T(1);
+    return res;
+}
+
+/// Dual quaternion linear blending (DLB) of n unit dual quaternions.
+/// The quaternions whose real part is in the opposite hemisphere of dq[0] are negated
+/// so that the blend takes the shortest path, the result is normalized.
+/// If the blend degenerates, e.g. all weights are zero, the identity is returned.
+template<typename T>
+dual_quaternion<T> blend(dual_quaternion<T> const* dq, T const* weights, std::size_t n)
+{
+    const quaternion<T> zero(T(0), T(0), T(0), T(0));
+    dual_quaternion<T> res(zero, zero);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        T w = dot(dq[0].real(), dq[i].real()) < T(0) ? -weights[i] : weights[i];
+        res += w * dq[i];
+    }
+
+    if (!res.normalize())
+    {
+        return dual_quaternion<T>::identity;
+    }
+    return res;
+}
+
+/// Dual quaternion linear blending of two unit dual quaternions by t
+template<typename T>
+inline dual_quaternion<T> blend(dual_quaternion<T> const& dq0, dual_quaternion<T> const& dq1, T t)
+{
+    dual_quaternion<T> dq[] = { dq0, dq1 };
+    T weights[] = { T(1) - t, t };
+    return blend(dq, weights, 2);
+}
+
+namespace detail
+{
+
+// Blend the transforms of the vertices [first, first + valid) into the SoA block b,
+// b[0..3] is the real part and b[4..7] the dual part. The dual part is only scaled,
+// its component parallel to the real part does not affect the transform.
+// The vertices without weight and the padding get the identity.
+template<typename T, std::size_t Lanes>
+void blend_skin_block(dual_quaternion<T> const* palette, std::size_t influences,
+                      std::size_t const* joints, T const* weights,
+                      std::size_t first, std::size_t valid, T (&b)[8][Lanes])
+{
+    using std::sqrt;
+
+    for (std::size_t l = 0; l < Lanes; ++l)
+    {
+        T acc[8] = {};
+        if (l < valid && influences > 0)
+        {
+            std::size_t const* vj = joints + (first + l) * influences;
+            T const* vw = weights + (first + l) * influences;
+            quaternion<T> const& r0 = palette[vj[0]].real();
+            for (std::size_t i = 0; i < influences; ++i)
+            {
+                dual_quaternion<T> const& dq = palette[vj[i]];
+                T w = dot(r0, dq.real()) < T(0) ? -vw[i] : vw[i];
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    acc[c] += w * dq.real()[c];
+                    acc[c + 4] += w * dq.dual()[c];
+                }
+            }
+        }
+
+        T s = acc[0] * acc[0] + acc[1] * acc[1] + acc[2] * acc[2] + acc[3] * acc[3];
+        if (s > T(0))
+        {
+            T inv_len = T(1) / sqrt(s);
+            for (std::size_t c = 0; c < 8; ++c)
+            {
+                b[c][l] = acc[c] * inv_len;
+            }
+        }
+        else
+        {
+            for (std::size_t c = 0; c < 8; ++c)
+            {
+                b[c][l] = T(0);
+            }
+            b[0][l] = T(1);
+        }
+    }
+}
+
+} // namespace detail
+
+/// Skin the positions with dual quaternion linear blending.
+/// Every vertex has the given number of influences, the joint indices into palette and
+/// the weights of the k-th vertex are joints[k * influences + i] and weights[k * influences + i].
+/// The palette holds unit dual quaternions, the output may refer to the input.
+template<typename T>
+void skin(dual_quaternion<T> const* palette, std::size_t influences,
+          std::size_t const* joints, T const* weights,
+          vector_stream<T, 3> const& positions, vector_stream<T, 3>& out)
+{
+    out.resize(positions.size());
+
+    T const* px = positions.component(0);
+    T const* py = positions.component(1);
+    T const* pz = positions.component(2);
+    T* ox = out.component(0);
+    T* oy = out.component(1);
+    T* oz = out.component(2);
+
+    // gather and blend the transforms of a block, then transform the block's
+    // positions one per SIMD lane
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t size = positions.size();
+    std::size_t count = positions.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T b[8][lanes];
+        detail::blend_skin_block(palette, influences, joints, weights, first, (std::min)(lanes, size - first), b);
+
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            rx[l] = px[k];
+            ry[l] = py[k];
+            rz[l] = pz[k];
+            detail::transform_point(b[0][l], b[1][l], b[2][l], b[3][l], b[4][l], b[5][l], b[6][l], b[7][l],
+                                    rx[l], ry[l], rz[l]);
+        }
+
+        std::copy_n(rx, lanes, ox + first);
+        std::copy_n(ry, lanes, oy + first);
+        std::copy_n(rz, lanes, oz + first);
+    }
+}
+
+/// Skin the positions and the normals with dual quaternion linear blending,
+/// the normals are rotated only. See skin above for the layout of joints and weights.
+template<typename T>
+void skin(dual_quaternion<T> const* palette, std::size_t influences,
+          std::size_t const* joints, T const* weights,
+          vector_stream<T, 3> const& positions, vector_stream<T, 3> const& normals,
+          vector_stream<T, 3>& out_positions, vector_stream<T, 3>& out_normals)
+{
+    KISMET_ASSERT(positions.size() == normals.size());
+    out_positions.resize(positions.size());
+    out_normals.resize(normals.size());
+
+    T const* px = positions.component(0);
+    T const* py = positions.component(1);
+    T const* pz = positions.component(2);
+    T const* nx = normals.component(0);
+    T const* ny = normals.component(1);
+    T const* nz = normals.component(2);
+    T* opx = out_positions.component(0);
+    T* opy = out_positions.component(1);
+    T* opz = out_positions.component(2);
+    T* onx = out_normals.component(0);
+    T* ony = out_normals.component(1);
+    T* onz = out_normals.component(2);
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t size = positions.size();
+    std::size_t count = positions.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T b[8][lanes];
+        detail::blend_skin_block(palette, influences, joints, weights, first, (std::min)(lanes, size - first), b);
+
+        T rpx[lanes];
+        T rpy[lanes];
+        T rpz[lanes];
+        T rnx[lanes];
+        T rny[lanes];
+        T rnz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            rpx[l] = px[k];
+            rpy[l] = py[k];
+            rpz[l] = pz[k];
+            detail::transform_point(b[0][l], b[1][l], b[2][l], b[3][l], b[4][l], b[5][l], b[6][l], b[7][l],
+                                    rpx[l], rpy[l], rpz[l]);
+
+            // a zero dual part rotates only
+            rnx[l] = nx[k];
+            rny[l] = ny[k];
+            rnz[l] = nz[k];
+            detail::transform_point(b[0][l], b[1][l], b[2][l], b[3][l], T(0), T(0), T(0), T(0),
+                                    rnx[l], rny[l], rnz[l]);
+        }
+
+        std::copy_n(rpx, lanes, opx + first);
+        std::copy_n(rpy, lanes, opy + first);
+        std::copy_n(rpz, lanes, opz + first);
+        std::copy_n(rnx, lanes, onx + first);
+        std::copy_n(rny, lanes, ony + first);
+        std::copy_n(rnz, lanes, onz + first);
+    }
+}
+
+template<typename T>
+inline bool operator ==(dual_quaternion<T> const& lhs, dual_quaternion<T> const& rhs)
+{
+    return lhs.real() == rhs.real() && lhs.dual() == rhs.dual();
+}
+
+template<typename T>
+inline bool operator !=(dual_quaternion<T> const& lhs, dual_quaternion<T> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename T>
+inline std::ostream& operator <<(std::ostream& os, dual_quaternion<T> const& dq)
+{
+    return os << "[ " << dq.real() << ", " << dq.dual() << " ]";
+}
+
+using dual_quaternionf = dual_quaternion<float>;
+using dual_quaterniond = dual_quaternion<double>;
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_DUAL_QUATERNION_H
@@ -0,0 +1,162 @@
+#ifndef KISMET_MATH_EIGEN_H
+#define KISMET_MATH_EIGEN_H
+
+#include <algorithm>
+#include <cstddef>
+
+#include "kismet/math/detail/symmetric_eigen.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/matrix_batch.h"
+#include "kismet/math/quaternion.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/transform.h"
+#include "kismet/math/transform_batch.h"
+#include "kismet/math/vector.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+// Eigendecomposition of symmetric 3x3 matrices, e.g. inertia tensors and covariance matrices.
+// The eigenvalues are sorted in ascending order, the eigenvectors are the columns of a rotation
+// matrix in the same order, so that A = V*diag(values)*V^T, and V can also be returned as a
+// quaternion. Only the lower triangular part of A is accessed.
+
+/// Eigendecompose a symmetric 3x3 matrix with cyclic Jacobi rotations, which is accurate
+/// to the precision of T for any input, including repeated eigenvalues.
+/// The eigenvalues are in ascending order, the columns of the rotation matrix vectors are
+/// the corresponding unit eigenvectors.
+/// Return false if the iteration does not converge within max_sweeps, e.g. for NaN.
+template<typename T>
+bool eigen_decompose_jacobi(matrix<T, 3, 3> const& a, vector3<T>& values, matrix<T, 3, 3>& vectors,
+                            std::size_t max_sweeps = detail::jacobi_max_sweeps)
+{
+    T e[6];
+    T l[3];
+    T v[3][3];
+    detail::unique_elements(a, e);
+    bool converged = detail::eigen_jacobi(e, l, v, max_sweeps);
+    values = vector3<T>(l[0], l[1], l[2]);
+    std::copy_n(&v[0][0], 9, vectors.data());
+    return converged;
+}
+
+/// Eigendecompose a symmetric 3x3 matrix, see eigen_decompose_jacobi for the result.
+/// The closed form solution is tried first, which is about twice as fast. It falls back to
+/// Jacobi rotations if its residual ||A*v - l*v|| exceeds 256 epsilon relative to ||A||,
+/// which happens for close eigenvalues.
+/// Return false if the Jacobi iteration does not converge.
+template<typename T>
+bool eigen_decompose_symmetric(matrix<T, 3, 3> const& a, vector3<T>& values, matrix<T, 3, 3>& vectors)
+{
+    T e[6];
+    T l[3];
+    T v[3][3];
+    detail::unique_elements(a, e);
+    if (!detail::eigen_closed_form(e, l, v))
+    {
+        return eigen_decompose_jacobi(a, values, vectors);
+    }
+
+    values = vector3<T>(l[0], l[1], l[2]);
+    std::copy_n(&v[0][0], 9, vectors.data());
+    return true;
+}
+
+/// Eigendecompose a symmetric 3x3 matrix, the eigenvectors are returned as the quaternion
+/// of the rotation matrix V, so that A = V*diag(values)*V^T.
+/// Return false if the Jacobi iteration does not converge.
+template<typename T>
+bool eigen_decompose_symmetric(matrix<T, 3, 3> const& a, vector3<T>& values, quaternion<T>& vectors)
+{
+    matrix<T, 3, 3> v;
+    bool ok = eigen_decompose_symmetric(a, values, v);
+
+    matrix44<T> m(matrix44<T>::identity);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            m[i][j] = v[i][j];
+        }
+    }
+    vectors = matrix_to_quat(m);
+    return ok;
+}
+
+/// Eigendecompose a batch of symmetric 3x3 matrices, values[k] and vectors[k] are the
+/// result of the k-th matrix as in eigen_decompose_jacobi.
+/// Every lane runs the same fixed number of Jacobi sweeps and sorts without branches,
+/// so that the compiler maps one matrix to a SIMD lane. The closed form is not used, as
+/// its fallback would need a branch per lane. batch_kernels has it compiled for the
+/// instruction sets of the CPU.
+template<typename T>
+void eigen_decompose_symmetric(matrix_batch<T, 3, 3> const& a, vector_stream<T, 3>& values,
+                               matrix_batch<T, 3, 3>& vectors)
+{
+    values.resize(a.size());
+    vectors.resize(a.size());
+
+    T const* in[6] = { a.element(0, 0), a.element(1, 1), a.element(2, 2),
+                       a.element(1, 0), a.element(2, 0), a.element(2, 1) };
+    T* out_l[3] = { values.component(0), values.component(1), values.component(2) };
+    T* out_v[3][3];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            out_v[i][j] = vectors.element(i, j);
+        }
+    }
+
+    // blocked as the stream operations
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = a.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T d[6][lanes];
+        T v[3][3][lanes];
+        for (std::size_t e = 0; e < 6; ++e)
+        {
+            std::copy_n(in[e] + first, lanes, d[e]);
+        }
+        detail::jacobi_eigen(d, v);
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            std::copy_n(d[i], lanes, out_l[i] + first);
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::copy_n(v[i][j], lanes, out_v[i][j] + first);
+            }
+        }
+    }
+
+    // the zero padding has identity eigenvectors
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        detail::clear_padding(out_l[i], a.size(), count);
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            detail::clear_padding(out_v[i][j], a.size(), count);
+        }
+    }
+}
+
+/// Eigendecompose a batch of symmetric 3x3 matrices, the eigenvectors are returned as
+/// quaternions, see the overload above
+template<typename T>
+void eigen_decompose_symmetric(matrix_batch<T, 3, 3> const& a, vector_stream<T, 3>& values,
+                               quaternion_stream<T>& vectors)
+{
+    matrix_batch<T, 3, 3> v;
+    eigen_decompose_symmetric(a, values, v);
+    matrix_to_quat(v, vectors);
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_EIGEN_H
@@ -0,0 +1,459 @@
+#ifndef KISMET_MATH_ITERATIVE_SOLVER_H
+#define KISMET_MATH_ITERATIVE_SOLVER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/math_trait.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/sparse_matrix.h"
+#include "kismet/utility.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// Statistics of an iterative solve
+template<typename T>
+struct iterative_solve_info
+{
+    /// number of iterations performed
+    std::size_t iterations = 0;
+    /// 2-norm of the residual b - A*x of the returned solution
+    T residual = T(0);
+};
+
+/// Adapts a NxN matrix to the operator interface used by the iterative solvers.
+/// A matrix-free operator has to provide the same members, vectors are arrays of size() elements:
+///   size()         returns the number of unknowns
+///   apply(x, y)    computes y = A*x, used by conjugate_gradient
+///   diagonal(i)    returns A[i][i], used by jacobi and gauss_seidel
+///   row_dot(i, x)  returns the dot product of the i-th row of A and x,
+///                  used by jacobi and gauss_seidel
+template<typename T, std::size_t N>
+class matrix_operator
+{
+public:
+    explicit matrix_operator(matrix<T, N, N> const& a)
+        : m_a(a)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return N;
+    }
+
+    void apply(T const* x, T* y) const
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            y[i] = row_dot(i, x);
+        }
+    }
+
+    T diagonal(std::size_t i) const
+    {
+        return m_a[i][i];
+    }
+
+    T row_dot(std::size_t i, T const* x) const
+    {
+        T const* row = m_a[i].data();
+
+        T s(0);
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            s += row[j] * x[j];
+        }
+        return s;
+    }
+
+private:
+    matrix<T, N, N> const& m_a;
+};
+
+/// Adapts a square csr_matrix to the operator interface of the iterative solvers
+template<typename T>
+class csr_operator
+{
+public:
+    explicit csr_operator(csr_matrix<T> const& a)
+        : m_a(a)
+    {
+        KISMET_ASSERT(a.rows() == a.cols());
+    }
+
+    std::size_t size() const
+    {
+        return m_a.rows();
+    }
+
+    void apply(T const* x, T* y) const
+    {
+        multiply(m_a, x, y);
+    }
+
+    T diagonal(std::size_t i) const
+    {
+        return m_a(i, i);
+    }
+
+    T row_dot(std::size_t i, T const* x) const
+    {
+        std::size_t const* offsets = m_a.row_offsets();
+        std::size_t const* indices = m_a.column_indices();
+        T const* values = m_a.values();
+
+        T s(0);
+        for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+        {
+            s += values[k] * x[indices[k]];
+        }
+        return s;
+    }
+
+private:
+    csr_matrix<T> const& m_a;
+};
+
+/// Adapts a square bsr_matrix to the operator interface of the iterative solvers,
+/// the unknowns are the scalar rows
+template<typename T, std::size_t B>
+class bsr_operator
+{
+public:
+    explicit bsr_operator(bsr_matrix<T, B> const& a)
+        : m_a(a)
+    {
+        KISMET_ASSERT(a.block_rows() == a.block_cols());
+    }
+
+    std::size_t size() const
+    {
+        return m_a.block_rows() * B;
+    }
+
+    void apply(T const* x, T* y) const
+    {
+        multiply(m_a, x, y);
+    }
+
+    T diagonal(std::size_t i) const
+    {
+        return m_a(i, i);
+    }
+
+    T row_dot(std::size_t i, T const* x) const
+    {
+        std::size_t const* offsets = m_a.row_offsets();
+        std::size_t const* indices = m_a.column_indices();
+        matrix<T, B, B> const* blocks = m_a.blocks();
+        std::size_t block_row = i / B;
+
+        T s(0);
+        for (std::size_t k = offsets[block_row]; k < offsets[block_row + 1]; ++k)
+        {
+            T const* row = blocks[k][i % B].data();
+            T const* px = x + indices[k] * B;
+            for (std::size_t j = 0; j < B; ++j)
+            {
+                s += row[j] * px[j];
+            }
+        }
+        return s;
+    }
+
+private:
+    bsr_matrix<T, B> const& m_a;
+};
+
+namespace detail
+{
+
+// Gauss-Seidel checks the residual every few sweeps, as it costs another pass over A
+const std::size_t residual_check_interval = 4;
+
+template<typename T>
+inline T dot(std::size_t n, T const* a, T const* b)
+{
+    T s(0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        s += a[i] * b[i];
+    }
+    return s;
+}
+
+// 2-norm of b - A*x
+template<typename Op, typename T>
+T residual_norm(Op const& op, T const* b, T const* x)
+{
+    using std::sqrt;
+
+    T s(0);
+    for (std::size_t i = 0; i < op.size(); ++i)
+    {
+        T r = b[i] - op.row_dot(i, x);
+        s += r * r;
+    }
+    return sqrt(s);
+}
+
+template<typename T>
+inline void set_solve_info(iterative_solve_info<T>* info, std::size_t iterations, T residual)
+{
+    if (info)
+    {
+        info->iterations = iterations;
+        info->residual = residual;
+    }
+}
+
+// The solvers work on op.size() elements, the scratch arrays are provided by the callers,
+// so that systems of a fixed size don't allocate.
+
+template<typename Op, typename T>
+bool conjugate_gradient(Op const& op, T const* b, T* x, T* r, T* p, T* ap, std::size_t max_iterations,
+                        iterative_solve_info<T>* info, T tolerance)
+{
+    using std::sqrt;
+    using std::size_t;
+
+    size_t n = op.size();
+    op.apply(x, ap);
+    for (size_t i = 0; i < n; ++i)
+    {
+        r[i] = b[i] - ap[i];
+        p[i] = r[i];
+    }
+
+    T rr = dot(n, r, r);
+    size_t iter = 0;
+    for (; iter < max_iterations && sqrt(rr) > tolerance; ++iter)
+    {
+        op.apply(p, ap);
+
+        // A is not positive definite
+        T pap = dot(n, p, ap);
+        if (pap <= T(0))
+        {
+            break;
+        }
+
+        T alpha = rr / pap;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+        }
+
+        T rr_new = dot(n, r, r);
+        T beta = rr_new / rr;
+        for (size_t i = 0; i < n; ++i)
+        {
+            p[i] = r[i] + beta * p[i];
+        }
+        rr = rr_new;
+    }
+
+    // the recurrence residual drifts from the true one, report the latter
+    T residual = residual_norm(op, b, x);
+    set_solve_info(info, iter, residual);
+    return residual <= tolerance;
+}
+
+// Return false if A has a zero diagonal element
+template<typename Op, typename T>
+bool invert_diagonal(Op const& op, T const* b, T const* x, T* inv_diag, iterative_solve_info<T>* info)
+{
+    for (std::size_t i = 0; i < op.size(); ++i)
+    {
+        T d = op.diagonal(i);
+        if (is_zero(d, math_trait<T>::zero_tolerance()))
+        {
+            set_solve_info(info, 0, residual_norm(op, b, x));
+            return false;
+        }
+        inv_diag[i] = invert(d);
+    }
+    return true;
+}
+
+template<typename Op, typename T>
+bool jacobi(Op const& op, T const* b, T* x, T* inv_diag, T* prev, std::size_t max_iterations,
+            iterative_solve_info<T>* info, T tolerance)
+{
+    using std::sqrt;
+    using std::size_t;
+
+    if (!invert_diagonal(op, b, x, inv_diag, info))
+    {
+        return false;
+    }
+
+    size_t n = op.size();
+    for (size_t iter = 0;; ++iter)
+    {
+        std::copy_n(x, n, prev);
+
+        // the residual of the previous iterate falls out of the update for free
+        T s(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            T r = b[i] - op.row_dot(i, prev);
+            s += r * r;
+            x[i] = prev[i] + r * inv_diag[i];
+        }
+
+        // the previous iterate is the result, drop the update
+        T residual = sqrt(s);
+        if (residual <= tolerance || iter == max_iterations)
+        {
+            std::copy_n(prev, n, x);
+            set_solve_info(info, iter, residual);
+            return residual <= tolerance;
+        }
+    }
+}
+
+template<typename Op, typename T>
+bool gauss_seidel(Op const& op, T const* b, T* x, T* inv_diag, std::size_t max_iterations,
+                  iterative_solve_info<T>* info, T tolerance)
+{
+    using std::size_t;
+
+    if (!invert_diagonal(op, b, x, inv_diag, info))
+    {
+        return false;
+    }
+
+    size_t n = op.size();
+    T residual = residual_norm(op, b, x);
+    size_t iter = 0;
+    while (iter < max_iterations && residual > tolerance)
+    {
+        size_t sweeps = (std::min)(residual_check_interval, max_iterations - iter);
+        for (size_t sweep = 0; sweep < sweeps; ++sweep)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                x[i] += (b[i] - op.row_dot(i, x)) * inv_diag[i];
+            }
+        }
+        iter += sweeps;
+        residual = residual_norm(op, b, x);
+    }
+
+    set_solve_info(info, iter, residual);
+    return residual <= tolerance;
+}
+
+} // namespace detail
+
+/// Solve a symmetric positive definite linear system A*x = b using the conjugate gradient method.
+/// op is an operator as matrix_operator, b and x are arrays of op.size() elements.
+/// x is used as the initial guess, so the solution of a similar system (e.g. the one of the
+/// previous frame) makes the solver converge in a few iterations.
+/// The iteration stops when the 2-norm of the residual is not greater than tolerance or
+/// after max_iterations.
+/// Return true if the solver converges, x holds the last iterate in any case.
+template<typename Op, typename T>
+bool conjugate_gradient(Op const& op, T const* b, T* x, std::size_t max_iterations,
+                        iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    std::vector<T> scratch(3 * op.size());
+    T* r = scratch.data();
+    return detail::conjugate_gradient(op, b, x, r, r + op.size(), r + 2 * op.size(), max_iterations, info, tolerance);
+}
+
+/// Solve a symmetric positive definite linear system A*x = b of a fixed size, see above.
+/// The temporaries are on the stack, large systems should use the overload above.
+template<typename Op, typename T, std::size_t N>
+bool conjugate_gradient(Op const& op, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+                        iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(op.size() == N);
+
+    T r[N];
+    T p[N];
+    T ap[N];
+    return detail::conjugate_gradient(op, b.data(), x.data(), r, p, ap, max_iterations, info, tolerance);
+}
+
+template<typename T, std::size_t N>
+bool conjugate_gradient(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+                        iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return conjugate_gradient(matrix_operator<T, N>(a), b, x, max_iterations, info, tolerance);
+}
+
+/// Solve a linear system A*x = b using Jacobi iteration, which converges if A is
+/// strictly diagonally dominant.
+/// op, b and x are as conjugate_gradient, so is the stopping criterion.
+/// Return true if the solver converges, false if it does not or A has a zero diagonal element.
+template<typename Op, typename T>
+bool jacobi(Op const& op, T const* b, T* x, std::size_t max_iterations,
+            iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    std::vector<T> scratch(2 * op.size());
+    return detail::jacobi(op, b, x, scratch.data(), scratch.data() + op.size(), max_iterations, info, tolerance);
+}
+
+template<typename Op, typename T, std::size_t N>
+bool jacobi(Op const& op, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+            iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(op.size() == N);
+
+    T inv_diag[N];
+    T prev[N];
+    return detail::jacobi(op, b.data(), x.data(), inv_diag, prev, max_iterations, info, tolerance);
+}
+
+template<typename T, std::size_t N>
+bool jacobi(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+            iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return jacobi(matrix_operator<T, N>(a), b, x, max_iterations, info, tolerance);
+}
+
+/// Solve a linear system A*x = b using Gauss-Seidel iteration, which converges if A is
+/// strictly diagonally dominant or symmetric positive definite.
+/// op, b and x are as conjugate_gradient, x is updated in place. The residual is checked
+/// every 4 sweeps, as it costs another pass over A, so the iteration may run up to 3 sweeps
+/// longer than necessary.
+/// Return true if the solver converges, false if it does not or A has a zero diagonal element.
+template<typename Op, typename T>
+bool gauss_seidel(Op const& op, T const* b, T* x, std::size_t max_iterations,
+                  iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    std::vector<T> inv_diag(op.size());
+    return detail::gauss_seidel(op, b, x, inv_diag.data(), max_iterations, info, tolerance);
+}
+
+template<typename Op, typename T, std::size_t N>
+bool gauss_seidel(Op const& op, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+                  iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(op.size() == N);
+
+    T inv_diag[N];
+    return detail::gauss_seidel(op, b.data(), x.data(), inv_diag, max_iterations, info, tolerance);
+}
+
+template<typename T, std::size_t N>
+bool gauss_seidel(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, std::size_t max_iterations,
+                  iterative_solve_info<T>* info = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return gauss_seidel(matrix_operator<T, N>(a), b, x, max_iterations, info, tolerance);
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_ITERATIVE_SOLVER_H
@@ -155,11 +155,13 @@ bool forward_substitute(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matr
     return forward_substitute(a, b, x.data(), tolerance);
 }
 
-/// solve a linear system ax = b using Gaussian elimination with partial pivoting
+/// solve a linear system ax = b using Gaussian elimination with partial pivoting in place,
+/// a and b are destroyed, which saves the copies of solve_partial_pivoting
 /// a is coefficient matrix
 /// b is constant matrix
+/// x may refer to b.
 template<typename T, std::size_t N>
-bool solve_partial_pivoting(matrix<T, N, N> a, matrix<T, N, 1> b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+bool solve_partial_pivoting_inplace(matrix<T, N, N>& a, matrix<T, N, 1>& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
 {
     using std::size_t;
     using std::abs;
@@ -220,6 +222,15 @@ bool solve_partial_pivoting(matrix<T, N, N> a, matrix<T, N, 1> b, matrix<T, N, 1
     return true;
 }
 
+/// solve a linear system ax = b using Gaussian elimination with partial pivoting
+/// a is coefficient matrix
+/// b is constant matrix
+template<typename T, std::size_t N>
+bool solve_partial_pivoting(matrix<T, N, N> a, matrix<T, N, 1> b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return solve_partial_pivoting_inplace(a, b, x, tolerance);
+}
+
 /// LU decompose a matrix with Gaussian Elimination.
 /// The matrix A is decomposed as
 ///     A = L*U
@@ -441,6 +452,1116 @@ void plu_decompose(matrix<T, N, N> const& a, std::size_t (&p) [N], matrix<T, N,
     reorder(l.row_begin(), l.row_end(), perms);
 }
 
+namespace detail
+{
+
+// Decompose the matrix in place as
+//   P'*A = L*U
+// The multipliers of L are stored below the diagonal of lu and U is stored on
+// and above the diagonal. Unlike plu_decompose_helper, rows are swapped as a whole,
+// so perms[i] is the row of A which ends up in the i-th row of lu.
+template<typename T, std::size_t N>
+void plu_decompose_packed_helper(matrix<T, N, N>& lu, std::size_t (&perms) [N], T tolerance)
+{
+    using std::size_t;
+    using std::abs;
+    using std::swap;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        perms[i] = i;
+    }
+
+    // elimination process
+    for (size_t i = 0; i < N - 1; ++i)
+    {
+        // find the pivot in column i
+        T pivot = abs(lu[i][i]);
+
+        size_t pivot_row = i;
+        for (size_t j = i + 1; j < N; ++j)
+        {
+            T value = abs(lu[j][i]);
+            if (value > pivot)
+            {
+                pivot = value;
+                pivot_row = j;
+            }
+        }
+
+        // pivot is 0, no need to eliminate for this column,
+        // the remaining elements are treated as eliminated.
+        if (is_zero(pivot, tolerance))
+        {
+            for (size_t row = i + 1; row < N; ++row)
+            {
+                lu[row][i] = T(0);
+            }
+            continue;
+        }
+
+        // pivoting, the multipliers computed so far move along with the row
+        if (pivot_row != i)
+        {
+            lu[pivot_row].swap(lu[i]);
+            swap(perms[i], perms[pivot_row]);
+        }
+
+        T inv_pivot = invert(lu[i][i]);
+
+        // eliminate c[i + 1..N][i], the multiplier takes the place of the eliminated element.
+        for (size_t row = i + 1; row < N; ++row)
+        {
+            T scale = lu[row][i] * inv_pivot;
+            lu[row][i] = scale;
+
+            for (size_t col = i + 1; col < N; ++col)
+            {
+                lu[row][col] -= scale * lu[i][col];
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/// PLU decompose a matrix with Gaussian Elimination into a packed form.
+/// The matrix A is decomposed as
+///     A = P*L*U
+/// where P is an array which represents a permutation matrix as in plu_decompose,
+/// L is a unit lower triangular matrix whose elements below the diagonal are stored in lu,
+/// U is a upper triangular matrix which is stored on and above the diagonal of lu.
+/// a and lu may refer to the same matrix.
+template<typename T, std::size_t N>
+void plu_decompose_packed(matrix<T, N, N> const& a, std::size_t (&p) [N], matrix<T, N, N>& lu, T tolerance = math_trait<T>::zero_tolerance())
+{
+    std::size_t perms[N];
+
+    lu = a;
+    detail::plu_decompose_packed_helper(lu, perms, tolerance);
+
+    // P^T*A = L*U, see plu_decompose for the form of p
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        p[perms[i]] = i;
+    }
+}
+
+/// Forward substitution
+///   L*x=b
+/// L is a unit lower triangular matrix, only the elements below the diagonal are accessed,
+/// so the result of plu_decompose_packed can be used directly.
+/// x may refer to b.
+template<typename T, std::size_t N, typename RandIt>
+void forward_substitute_unit(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, RandIt x)
+{
+    for (std::size_t row = 0; row < N; ++row)
+    {
+        T v(b[row]);
+        for (std::size_t col = 0; col < row; ++col)
+        {
+            v -= l[row][col] * x[col];
+        }
+
+        x[row] = v;
+    }
+}
+
+template<typename T, std::size_t N>
+void forward_substitute_unit(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, matrix<T, N, 1>& x)
+{
+    forward_substitute_unit(l, b, x.data());
+}
+
+/// Solve a linear system A*x = b, where lu and p are the result of plu_decompose_packed.
+/// Return false if A is non-invertible
+template<typename T, std::size_t N>
+bool plu_solve(matrix<T, N, N> const& lu, std::size_t const (&p) [N], matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    // L*U*x = P^T*b
+    // as P[i][p[i]] = 1, we have (P^T*b)[p[i]] = b[i]
+    matrix<T, N, 1> y;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        y.data()[p[i]] = b.data()[i];
+    }
+
+    // solve L*y = P^T*b in place
+    forward_substitute_unit(lu, y, y.data());
+
+    // solve U*x = y
+    return backward_substitute(lu, y, x, tolerance);
+}
+
+// Branch free variants of the decompositions and substitutions. They run a fixed number of
+// iterations and never return early: a singular matrix clears the returned flag and yields
+// zeros instead, so that any system runs the same instruction stream. They are the scalar
+// form of the batch kernels in linear_system_batch.h, which run one system per SIMD lane.
+
+namespace detail
+{
+
+// Return the inverse of the pivot, or 0 if the pivot is zero in which case ok is cleared
+template<typename T>
+inline T safe_invert(T pivot, bool& ok, T tolerance)
+{
+    T singular = is_zero(pivot, tolerance) ? T(1) : T(0);
+    ok = ok & (singular == T(0));
+
+    // blend arithmetically, so that a zero pivot is never divided by and
+    // the compiler does not need a branch which stops vectorization
+    return (T(1) - singular) / (pivot + singular);
+}
+
+template<typename T>
+inline void swap_if(bool cond, T& a, T& b)
+{
+    T ta = a;
+    T tb = b;
+    a = cond ? tb : ta;
+    b = cond ? ta : tb;
+}
+
+} // namespace detail
+
+/// LU decompose a matrix as lu_decompose, without branches on the elements.
+/// Return false where lu_decompose does, i.e. a zero pivot above a non zero element,
+/// in which case l and u are unspecified.
+template<typename T, std::size_t N>
+bool lu_decompose_branchless(matrix<T, N, N> const& a, matrix<T, N, N>& l, matrix<T, N, N>& u, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+
+    u = a;
+    l = matrix<T, N, N>::identity;
+
+    bool ok = true;
+    for (size_t i = 0; i < N - 1; ++i)
+    {
+        // a zero pivot has zero multipliers, which is only right if the column is zero below it
+        bool regular = true;
+        T inv_pivot = detail::safe_invert(u[i][i], regular, tolerance);
+
+        for (size_t row = i + 1; row < N; ++row)
+        {
+            ok = ok & (regular | is_zero(u[row][i], tolerance));
+
+            T scale = u[row][i] * inv_pivot;
+            u[row][i] = T(0);
+            l[row][i] = scale;
+
+            for (size_t col = i + 1; col < N; ++col)
+            {
+                u[row][col] -= scale * u[i][col];
+            }
+        }
+    }
+
+    return ok;
+}
+
+/// PLU decompose a matrix into the packed form of plu_decompose_packed, without branches
+/// on the elements. The pivot is selected with conditional moves and the rows are swapped
+/// through an index, so that the result is the same as of plu_decompose_packed.
+/// Return false if A is singular, the columns of zero pivots have zero multipliers.
+template<typename T, std::size_t N>
+bool plu_decompose_packed_branchless(matrix<T, N, N> const& a, std::size_t (&p) [N], matrix<T, N, N>& lu, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+    using std::abs;
+    using std::swap;
+
+    // rows[i] is the row of m which is the i-th row of the decomposition
+    matrix<T, N, N> m = a;
+    size_t rows[N];
+    for (size_t i = 0; i < N; ++i)
+    {
+        rows[i] = i;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < N; ++i)
+    {
+        T pivot = abs(m[rows[i]][i]);
+        size_t pivot_row = i;
+        for (size_t j = i + 1; j < N; ++j)
+        {
+            T value = abs(m[rows[j]][i]);
+            bool larger = value > pivot;
+            pivot = larger ? value : pivot;
+            pivot_row = larger ? j : pivot_row;
+        }
+        swap(rows[i], rows[pivot_row]);
+
+        T const* u = m[rows[i]].data();
+        T inv_pivot = detail::safe_invert(u[i], ok, tolerance);
+        for (size_t row = i + 1; row < N; ++row)
+        {
+            T* r = m[rows[row]].data();
+            T scale = r[i] * inv_pivot;
+            r[i] = scale;
+
+            for (size_t col = i + 1; col < N; ++col)
+            {
+                r[col] -= scale * u[col];
+            }
+        }
+    }
+
+    // P^T*A = L*U, see plu_decompose for the form of p
+    for (size_t i = 0; i < N; ++i)
+    {
+        for (size_t j = 0; j < N; ++j)
+        {
+            lu[i][j] = m[rows[i]][j];
+        }
+        p[rows[i]] = i;
+    }
+    return ok;
+}
+
+/// Backward substitution
+///   U*x=b
+/// as backward_substitute, without branches on the elements. The inverses of the diagonal
+/// are computed first, which takes the divisions off the dependency chain of the unknowns.
+/// Return false if U is singular, the unknowns of the zero pivots are zero.
+template<typename T, std::size_t N, typename RandIt>
+bool backward_substitute_branchless(matrix<T, N, N> const& u, matrix<T, N, 1> const& b, RandIt x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    bool ok = true;
+    T inv_diagonal[N];
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        inv_diagonal[i] = detail::safe_invert(u[i][i], ok, tolerance);
+    }
+
+    for (std::size_t row = N; row--;)
+    {
+        T v(b[row]);
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            v -= u[row][col] * x[col];
+        }
+
+        x[row] = v * inv_diagonal[row];
+    }
+
+    return ok;
+}
+
+template<typename T, std::size_t N>
+bool backward_substitute_branchless(matrix<T, N, N> const& u, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return backward_substitute_branchless(u, b, x.data(), tolerance);
+}
+
+/// Forward substitution
+///   L*x=b
+/// as forward_substitute, without branches on the elements.
+/// Return false if L is singular, the unknowns of the zero pivots are zero.
+template<typename T, std::size_t N, typename RandIt>
+bool forward_substitute_branchless(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, RandIt x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    bool ok = true;
+    T inv_diagonal[N];
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        inv_diagonal[i] = detail::safe_invert(l[i][i], ok, tolerance);
+    }
+
+    for (std::size_t row = 0; row < N; ++row)
+    {
+        T v(b[row]);
+        for (std::size_t col = 0; col < row; ++col)
+        {
+            v -= l[row][col] * x[col];
+        }
+
+        x[row] = v * inv_diagonal[row];
+    }
+
+    return ok;
+}
+
+template<typename T, std::size_t N>
+bool forward_substitute_branchless(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return forward_substitute_branchless(l, b, x.data(), tolerance);
+}
+
+/// Solve a linear system A*x = b as plu_solve, without branches on the elements.
+/// lu and p are the result of plu_decompose_packed or plu_decompose_packed_branchless.
+/// Return false if A is singular.
+template<typename T, std::size_t N>
+bool plu_solve_branchless(matrix<T, N, N> const& lu, std::size_t const (&p) [N], matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix<T, N, 1> y;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        y.data()[p[i]] = b.data()[i];
+    }
+
+    forward_substitute_unit(lu, y, y.data());
+    return backward_substitute_branchless(lu, y, x, tolerance);
+}
+
+/// Statistics of solve_mixed_precision
+template<typename T>
+struct mixed_precision_info
+{
+    /// number of refinement steps performed with the low precision factorization
+    std::size_t iterations = 0;
+    /// infinity norm of the residual b - A*x of the returned solution
+    T residual = T(0);
+    /// whether the refinement stalled and the system was solved by a factorization in T
+    bool fallback = false;
+};
+
+namespace detail
+{
+
+template<typename T, std::size_t N>
+inline T norm_inf(matrix<T, N, 1> const& v)
+{
+    using std::abs;
+
+    T s(0);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        s = (std::max)(s, abs(v.data()[i]));
+    }
+    return s;
+}
+
+// Sum f(a[j], b[j]) over j < N. The partial sums are independent, so that the additions
+// are not serialized by their latency and the compiler packs them into SIMD registers.
+template<std::size_t N, typename T, typename F>
+inline T partial_sums(T const* a, T const* b, F f)
+{
+    const std::size_t K = 8;
+    const std::size_t M = N - N % K;
+
+    T s[K] = {};
+    for (std::size_t j = 0; j < M; j += K)
+    {
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            s[k] += f(a[j + k], b[j + k]);
+        }
+    }
+
+    T sum(0);
+    for (std::size_t j = M; j < N; ++j)
+    {
+        sum += f(a[j], b[j]);
+    }
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        sum += s[k];
+    }
+    return sum;
+}
+
+// the maximum absolute row sum
+template<typename T, std::size_t N>
+inline T norm_inf(matrix<T, N, N> const& a)
+{
+    using std::abs;
+
+    T s(0);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T const* row = a[i].data();
+        s = (std::max)(s, partial_sums<N>(row, row, [](T x, T) { return abs(x); }));
+    }
+    return s;
+}
+
+// r = b - A*x
+template<typename T, std::size_t N>
+inline void residual(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1> const& x,
+                     matrix<T, N, 1>& r)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T dot = partial_sums<N>(a[i].data(), x.data(), [](T u, T v) { return u * v; });
+        r.data()[i] = b.data()[i] - dot;
+    }
+}
+
+template<typename T>
+inline void set_mixed_precision_info(mixed_precision_info<T>* info, std::size_t iterations, T residual, bool fallback)
+{
+    if (info)
+    {
+        info->iterations = iterations;
+        info->residual = residual;
+        info->fallback = fallback;
+    }
+}
+
+} // namespace detail
+
+/// Solve a linear system A*x = b by factoring A in the lower precision Low, e.g. float for
+/// a double system, and refining the solution in T with the residual:
+///     x += solve(L*U, b - A*x)
+/// until the residual is at the accuracy of T, i.e.
+///     ||b - A*x|| <= sqrt(N) * epsilon * ||A|| * ||x||  (infinity norms)
+/// The factorization, which dominates the cost, moves half the data, and a moderately
+/// conditioned system converges in a few steps.
+/// If the residual does not at least halve in a step, the system is too ill conditioned
+/// for Low, or if A does not fit in Low, x is recomputed with plu_decompose_packed in T.
+/// Return false if A is non-invertible in T.
+template<typename Low = float, typename T, std::size_t N>
+bool solve_mixed_precision(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1>& x,
+                           std::size_t max_iterations = 10, mixed_precision_info<T>* info = nullptr,
+                           T tolerance = math_trait<T>::zero_tolerance())
+{
+    static_assert(sizeof(Low) < sizeof(T), "Low must be less precise than T");
+
+    T a_norm = detail::norm_inf(a);
+    T threshold = std::sqrt(T(N)) * std::numeric_limits<T>::epsilon() * a_norm;
+    std::size_t iterations = 0;
+
+    // the largest element is below the row sum, check it fits with headroom for the elimination
+    if (a_norm < T((std::numeric_limits<Low>::max)()) * T(0.5))
+    {
+        matrix<Low, N, N> lu(a);
+        std::size_t p[N];
+        plu_decompose_packed(lu, p, lu);
+
+        matrix<Low, N, 1> d;
+        if (plu_solve(lu, p, matrix<Low, N, 1>(b), d))
+        {
+            matrix<T, N, 1> r;
+            x = d;
+            T prev_norm = std::numeric_limits<T>::infinity();
+            for (;;)
+            {
+                detail::residual(a, b, x, r);
+                T r_norm = detail::norm_inf(r);
+                if (r_norm <= threshold * detail::norm_inf(x))
+                {
+                    detail::set_mixed_precision_info(info, iterations, r_norm, false);
+                    return true;
+                }
+
+                // stalled, also if the residual is not finite
+                if (iterations == max_iterations || !(r_norm <= prev_norm * T(0.5)))
+                {
+                    break;
+                }
+
+                // the correction is solved in Low, as U is invertible it succeeds
+                plu_solve(lu, p, matrix<Low, N, 1>(r), d);
+                x += matrix<T, N, 1>(d);
+                prev_norm = r_norm;
+                ++iterations;
+            }
+        }
+    }
+
+    // fall back to the factorization in T
+    matrix<T, N, N> lu;
+    std::size_t p[N];
+    plu_decompose_packed(a, p, lu, tolerance);
+    bool solved = plu_solve(lu, p, b, x, tolerance);
+
+    matrix<T, N, 1> r;
+    detail::residual(a, b, x, r);
+    detail::set_mixed_precision_info(info, iterations, detail::norm_inf(r), true);
+    return solved;
+}
+
+/// Solve the transposed linear system A^T*x = b, where lu and p are the result of
+/// plu_decompose_packed.
+/// Return false if A is non-invertible
+template<typename T, std::size_t N>
+bool plu_solve_transposed(matrix<T, N, N> const& lu, std::size_t const (&p) [N], matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    // A^T = U^T*L^T*P^T, solve U^T*z = b
+    matrix<T, N, 1> z;
+    for (std::size_t row = 0; row < N; ++row)
+    {
+        T coff = lu[row][row];
+        if (is_zero(coff, tolerance))
+        {
+            return false;
+        }
+
+        T v(b.data()[row]);
+        for (std::size_t col = 0; col < row; ++col)
+        {
+            v -= lu[col][row] * z.data()[col];
+        }
+        z.data()[row] = v * invert(coff);
+    }
+
+    // solve L^T*w = z in place
+    for (std::size_t row = N; row--;)
+    {
+        T v(z.data()[row]);
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            v -= lu[col][row] * z.data()[col];
+        }
+        z.data()[row] = v;
+    }
+
+    // x = P*w, as P[i][p[i]] = 1
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        x.data()[i] = z.data()[p[i]];
+    }
+    return true;
+}
+
+/// Return the 1-norm of a matrix, i.e. the maximum absolute column sum
+template<typename T, std::size_t N1, std::size_t N2>
+T norm_1(matrix<T, N1, N2> const& a)
+{
+    using std::abs;
+
+    T s(0);
+    for (std::size_t j = 0; j < N2; ++j)
+    {
+        T sum(0);
+        for (std::size_t i = 0; i < N1; ++i)
+        {
+            sum += abs(a[i][j]);
+        }
+        s = (std::max)(s, sum);
+    }
+    return s;
+}
+
+/// Estimate the 1-norm condition number ||A||_1 * ||A^-1||_1 from the result of
+/// plu_decompose_packed, where a_norm is norm_1(A).
+/// ||A^-1||_1 is estimated with Hager's method as refined by Higham, which solves a few
+/// systems with the factors, O(N^2) each, instead of computing the O(N^3) inverse.
+/// The estimate is a lower bound, which is rarely off by more than a factor of 3.
+/// Return infinity if A is non-invertible.
+template<typename T, std::size_t N>
+T condition_estimate(matrix<T, N, N> const& lu, std::size_t const (&p) [N], T a_norm, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::abs;
+
+    const T infinity = std::numeric_limits<T>::infinity();
+    const std::size_t max_iterations = 5;
+
+    // start with the average of the columns of A^-1
+    matrix<T, N, 1> x;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        x.data()[i] = T(1) / T(N);
+    }
+
+    matrix<T, N, 1> y;
+    matrix<T, N, 1> z;
+    T estimate(0);
+    std::size_t last = N;
+    for (std::size_t k = 0; k < max_iterations; ++k)
+    {
+        if (!plu_solve(lu, p, x, y, tolerance))
+        {
+            return infinity;
+        }
+
+        T y_norm(0);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            y_norm += abs(y.data()[i]);
+        }
+
+        // no progress, the estimate is a local maximum
+        if (k > 0 && y_norm <= estimate)
+        {
+            break;
+        }
+        estimate = y_norm;
+
+        // the subgradient of ||A^-1*x||_1
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            y.data()[i] = y.data()[i] < T(0) ? T(-1) : T(1);
+        }
+        plu_solve_transposed(lu, p, y, z, tolerance);
+
+        std::size_t j = 0;
+        T z_dot_x(0);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            z_dot_x += z.data()[i] * x.data()[i];
+            if (abs(z.data()[i]) > abs(z.data()[j]))
+            {
+                j = i;
+            }
+        }
+        if (abs(z.data()[j]) <= z_dot_x || j == last)
+        {
+            break;
+        }
+
+        // move to the column of A^-1 with the steepest ascent
+        std::fill_n(x.data(), N, T(0));
+        x.data()[j] = T(1);
+        last = j;
+    }
+
+    // Higham's alternative vector, it catches the matrices which make Hager's method stall
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T sign = i % 2 == 0 ? T(1) : T(-1);
+        x.data()[i] = N > 1 ? sign * (T(1) + T(i) / T(N - 1)) : T(1);
+    }
+    plu_solve(lu, p, x, y, tolerance);
+
+    T alt_norm(0);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        alt_norm += abs(y.data()[i]);
+    }
+    estimate = (std::max)(estimate, T(2) * alt_norm / T(3 * N));
+
+    return a_norm * estimate;
+}
+
+/// Estimate the 1-norm condition number of a, see the overload above.
+/// A well conditioned system, e.g. condition_estimate(a) * epsilon well below the accuracy
+/// required, can take a cheaper solver.
+template<typename T, std::size_t N>
+T condition_estimate(matrix<T, N, N> const& a, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix<T, N, N> lu;
+    std::size_t p[N];
+    plu_decompose_packed(a, p, lu, tolerance);
+    return condition_estimate(lu, p, norm_1(a), tolerance);
+}
+
+/// PLUQ decompose a matrix with Gaussian Elimination and full pivoting into a packed form.
+/// The matrix A is decomposed as
+///     A = P*L*U*Q^T
+/// where P and Q are arrays which represent the row and column permutation matrices as p
+/// in plu_decompose, L and U are stored in lu as in plu_decompose_packed.
+/// The pivot is the largest element of the remaining submatrix, so the elimination stops
+/// at the first pivot which is zero within tolerance, and U is zero from there on.
+/// a and lu may refer to the same matrix.
+/// Return the numerical rank of A, i.e. the number of non-zero pivots.
+template<typename T, std::size_t N>
+std::size_t pluq_decompose(matrix<T, N, N> const& a, std::size_t (&p) [N], std::size_t (&q) [N],
+                           matrix<T, N, N>& lu, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+    using std::abs;
+    using std::swap;
+
+    size_t rows[N];
+    size_t cols[N];
+    for (size_t i = 0; i < N; ++i)
+    {
+        rows[i] = i;
+        cols[i] = i;
+    }
+
+    lu = a;
+    size_t rank = N;
+    for (size_t i = 0; i < N; ++i)
+    {
+        // find the pivot in the submatrix [i..N][i..N]
+        T pivot(0);
+        size_t pivot_row = i;
+        size_t pivot_col = i;
+        for (size_t row = i; row < N; ++row)
+        {
+            for (size_t col = i; col < N; ++col)
+            {
+                T value = abs(lu[row][col]);
+                if (value > pivot)
+                {
+                    pivot = value;
+                    pivot_row = row;
+                    pivot_col = col;
+                }
+            }
+        }
+
+        // the remaining submatrix is zero
+        if (is_zero(pivot, tolerance))
+        {
+            for (size_t row = i; row < N; ++row)
+            {
+                for (size_t col = i; col < N; ++col)
+                {
+                    lu[row][col] = T(0);
+                }
+            }
+            rank = i;
+            break;
+        }
+
+        if (pivot_row != i)
+        {
+            lu[pivot_row].swap(lu[i]);
+            swap(rows[i], rows[pivot_row]);
+        }
+        if (pivot_col != i)
+        {
+            for (size_t row = 0; row < N; ++row)
+            {
+                swap(lu[row][i], lu[row][pivot_col]);
+            }
+            swap(cols[i], cols[pivot_col]);
+        }
+
+        T inv_pivot = invert(lu[i][i]);
+        for (size_t row = i + 1; row < N; ++row)
+        {
+            T scale = lu[row][i] * inv_pivot;
+            lu[row][i] = scale;
+
+            for (size_t col = i + 1; col < N; ++col)
+            {
+                lu[row][col] -= scale * lu[i][col];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        p[rows[i]] = i;
+        q[cols[i]] = i;
+    }
+    return rank;
+}
+
+/// Solve a linear system A*x = b, where lu, p and q are the result of pluq_decompose.
+/// Return false if A is non-invertible, i.e. its rank is less than N
+template<typename T, std::size_t N>
+bool pluq_solve(matrix<T, N, N> const& lu, std::size_t const (&p) [N], std::size_t const (&q) [N],
+                matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    // L*U*(Q^T*x) = P^T*b
+    matrix<T, N, 1> z;
+    if (!plu_solve(lu, p, b, z, tolerance))
+    {
+        return false;
+    }
+
+    // (Q^T*x)[q[i]] = x[i]
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        x.data()[i] = z.data()[q[i]];
+    }
+    return true;
+}
+
+/// Cholesky decompose a symmetric positive definite matrix.
+/// The matrix A is decomposed as
+///     A = L*L^T
+/// where L is a lower triangular matrix. Only the lower triangular part of A is accessed,
+/// a and l may refer to the same matrix.
+/// Return false if A is not positive definite, i.e. a pivot is not greater than tolerance,
+/// in which case l is left partially decomposed.
+template<typename T, std::size_t N>
+bool cholesky_decompose(matrix<T, N, N> const& a, matrix<T, N, N>& l, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+    using std::sqrt;
+
+    for (size_t j = 0; j < N; ++j)
+    {
+        T d(a[j][j]);
+        for (size_t k = 0; k < j; ++k)
+        {
+            d -= l[j][k] * l[j][k];
+        }
+
+        // not positive definite, fail
+        if (d <= tolerance)
+        {
+            return false;
+        }
+
+        d = sqrt(d);
+        l[j][j] = d;
+
+        T inv_d = invert(d);
+        for (size_t i = j + 1; i < N; ++i)
+        {
+            T v(a[i][j]);
+            for (size_t k = 0; k < j; ++k)
+            {
+                v -= l[i][k] * l[j][k];
+            }
+            l[i][j] = v * inv_d;
+
+            // the upper triangular part
+            l[j][i] = T(0);
+        }
+    }
+
+    return true;
+}
+
+/// LDL^T decompose a symmetric matrix.
+/// The matrix A is decomposed as
+///     A = L*D*L^T
+/// where L is a unit lower triangular matrix, D is a diagonal matrix whose diagonal is stored in d.
+/// Only the lower triangular part of A is accessed, a and l may refer to the same matrix.
+/// Unlike cholesky_decompose, A needs not be positive definite.
+/// Return false if a pivot of D is zero.
+template<typename T, std::size_t N>
+bool ldlt_decompose(matrix<T, N, N> const& a, matrix<T, N, N>& l, matrix<T, N, 1>& d, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+
+    for (size_t j = 0; j < N; ++j)
+    {
+        T dj(a[j][j]);
+        for (size_t k = 0; k < j; ++k)
+        {
+            dj -= l[j][k] * l[j][k] * d[k];
+        }
+
+        if (is_zero(dj, tolerance))
+        {
+            return false;
+        }
+
+        d[j] = dj;
+        l[j][j] = T(1);
+
+        T inv_d = invert(dj);
+        for (size_t i = j + 1; i < N; ++i)
+        {
+            T v(a[i][j]);
+            for (size_t k = 0; k < j; ++k)
+            {
+                v -= l[i][k] * l[j][k] * d[k];
+            }
+            l[i][j] = v * inv_d;
+
+            // the upper triangular part
+            l[j][i] = T(0);
+        }
+    }
+
+    return true;
+}
+
+namespace detail
+{
+
+// Backward substitution with the transpose of a lower triangular matrix
+//   L^T*x=b
+// x may refer to b
+template<bool Unit, typename T, std::size_t N, typename RandIt>
+void backward_substitute_transposed_impl(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, RandIt x)
+{
+    for (std::size_t row = N; row--;)
+    {
+        T v(b[row]);
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            v -= l[col][row] * x[col];
+        }
+
+        x[row] = Unit ? v : v * invert(T(l[row][row]));
+    }
+}
+
+} // namespace detail
+
+/// Solve a linear system A*x = b, where l is the result of cholesky_decompose
+template<typename T, std::size_t N>
+void cholesky_solve(matrix<T, N, N> const& l, matrix<T, N, 1> const& b, matrix<T, N, 1>& x)
+{
+    // solve L*y = b, the diagonal of a successful decomposition is never zero
+    for (std::size_t row = 0; row < N; ++row)
+    {
+        T v(b[row]);
+        for (std::size_t col = 0; col < row; ++col)
+        {
+            v -= l[row][col] * x[col];
+        }
+
+        x[row] = v * invert(T(l[row][row]));
+    }
+
+    // solve L^T*x = y
+    detail::backward_substitute_transposed_impl<false>(l, x, x.data());
+}
+
+/// Solve a linear system A*x = b, where l and d are the result of ldlt_decompose
+template<typename T, std::size_t N>
+void ldlt_solve(matrix<T, N, N> const& l, matrix<T, N, 1> const& d, matrix<T, N, 1> const& b, matrix<T, N, 1>& x)
+{
+    // solve L*z = b
+    forward_substitute_unit(l, b, x.data());
+
+    // solve D*y = z
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        x[i] *= invert(T(d[i]));
+    }
+
+    // solve L^T*x = y
+    detail::backward_substitute_transposed_impl<true>(l, x, x.data());
+}
+
+/// solve a linear system ax = b using Cholesky decomposition
+/// a is a symmetric positive definite coefficient matrix
+/// b is constant matrix
+/// Return false if a is not positive definite
+template<typename T, std::size_t N>
+bool solve_cholesky(matrix<T, N, N> const& a, matrix<T, N, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix<T, N, N> l;
+    if (!cholesky_decompose(a, l, tolerance))
+    {
+        return false;
+    }
+
+    cholesky_solve(l, b, x);
+    return true;
+}
+
+/// QR decompose a matrix with Householder reflections.
+/// The MxN matrix A, where M >= N, is decomposed as
+///     A = Q*R
+/// where Q is an orthogonal matrix, R is an upper triangular matrix.
+/// The decomposition is stored in a compact form, the Householder vectors which form Q
+/// are stored on and below the diagonal of qr, R is stored above the diagonal of qr
+/// except for its diagonal which is stored in rdiag.
+/// a and qr may refer to the same matrix.
+/// Return false if A does not have full column rank.
+template<typename T, std::size_t M, std::size_t N>
+bool qr_decompose(matrix<T, M, N> const& a, matrix<T, M, N>& qr, matrix<T, N, 1>& rdiag, T tolerance = math_trait<T>::zero_tolerance())
+{
+    static_assert(M >= N, "the matrix must have at least as many rows as columns");
+
+    using std::size_t;
+    using std::sqrt;
+
+    qr = a;
+
+    bool full_rank = true;
+    for (size_t k = 0; k < N; ++k)
+    {
+        // the norm of the k-th column below the diagonal
+        T norm(0);
+        for (size_t i = k; i < M; ++i)
+        {
+            norm += qr[i][k] * qr[i][k];
+        }
+        norm = sqrt(norm);
+
+        // rank deficient, nothing to reflect for this column
+        if (is_zero(norm, tolerance))
+        {
+            rdiag[k] = T(0);
+            full_rank = false;
+            continue;
+        }
+
+        // reflect to the side which avoids cancellation
+        if (qr[k][k] < T(0))
+        {
+            norm = -norm;
+        }
+
+        // form the k-th Householder vector
+        T inv_norm = invert(norm);
+        for (size_t i = k; i < M; ++i)
+        {
+            qr[i][k] *= inv_norm;
+        }
+        qr[k][k] += T(1);
+
+        // apply the reflection to the remaining columns
+        for (size_t j = k + 1; j < N; ++j)
+        {
+            T s(0);
+            for (size_t i = k; i < M; ++i)
+            {
+                s += qr[i][k] * qr[i][j];
+            }
+            s = -s / qr[k][k];
+
+            for (size_t i = k; i < M; ++i)
+            {
+                qr[i][j] += s * qr[i][k];
+            }
+        }
+
+        rdiag[k] = -norm;
+    }
+
+    return full_rank;
+}
+
+/// Solve a linear system A*x = b in the least squares sense, i.e. x minimizes ||A*x - b||,
+/// where qr and rdiag are the result of qr_decompose.
+/// Return false if A does not have full column rank.
+template<typename T, std::size_t M, std::size_t N>
+bool qr_solve(matrix<T, M, N> const& qr, matrix<T, N, 1> const& rdiag, matrix<T, M, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::size_t;
+
+    // y = Q^T*b
+    matrix<T, M, 1> y(b);
+    for (size_t k = 0; k < N; ++k)
+    {
+        if (is_zero(T(rdiag[k]), tolerance))
+        {
+            return false;
+        }
+
+        T s(0);
+        for (size_t i = k; i < M; ++i)
+        {
+            s += qr[i][k] * y[i];
+        }
+        s = -s / qr[k][k];
+
+        for (size_t i = k; i < M; ++i)
+        {
+            y[i] += s * qr[i][k];
+        }
+    }
+
+    // solve R*x = y
+    for (size_t row = N; row--;)
+    {
+        T v(y[row]);
+        for (size_t col = row + 1; col < N; ++col)
+        {
+            v -= qr[row][col] * x[col];
+        }
+
+        x[row] = v * invert(T(rdiag[row]));
+    }
+
+    return true;
+}
+
+/// solve a linear system ax = b in the least squares sense using Householder QR decomposition
+/// a is a MxN coefficient matrix, where M >= N
+/// b is constant matrix
+/// Return false if a does not have full column rank
+template<typename T, std::size_t M, std::size_t N>
+bool solve_least_squares(matrix<T, M, N> const& a, matrix<T, M, 1> const& b, matrix<T, N, 1>& x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix<T, M, N> qr;
+    matrix<T, N, 1> rdiag;
+    if (!qr_decompose(a, qr, rdiag, tolerance))
+    {
+        return false;
+    }
+
+    return qr_solve(qr, rdiag, b, x, tolerance);
+}
+
 KISMET_FUNC_TEMPLATE_API(solve, bool, float const a[2][2], float const b[2], float* it, float tol)
 KISMET_FUNC_TEMPLATE_API(solve, bool, double const a[2][2], double const b[2], double* it, double tol)
 
@@ -0,0 +1,778 @@
+#ifndef KISMET_MATH_LINEAR_SYSTEM_BATCH_H
+#define KISMET_MATH_LINEAR_SYSTEM_BATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/linear_system.h"
+#include "kismet/math/math_trait.h"
+#include "kismet/math/matrix_batch.h"
+
+namespace kismet
+{
+namespace math
+{
+
+// Batch solvers work on one system per lane. They never take a data dependent branch
+// for a single system: a system which has no unique solution is reported through the
+// per system flags and simply yields zeros, so all lanes can run in lockstep.
+
+namespace detail
+{
+
+// Number of systems processed at a time by the solvers which need a working copy,
+// chosen so that the working set stays in L1 cache.
+constexpr std::size_t batch_block_size = 32;
+
+// Working copy of a block of N1xN2 matrices, element (i, j) of the k-th matrix is [i][j][k]
+template<typename T, std::size_t N1, std::size_t N2>
+using batch_block = T[N1][N2][batch_block_size];
+
+template<typename T, std::size_t N1, std::size_t N2>
+inline void batch_load(matrix_batch<T, N1, N2> const& src, std::size_t first, std::size_t count, batch_block<T, N1, N2>& dst)
+{
+    for (std::size_t i = 0; i < N1; ++i)
+    {
+        for (std::size_t j = 0; j < N2; ++j)
+        {
+            std::copy_n(src.element(i, j) + first, count, dst[i][j]);
+        }
+    }
+}
+
+template<typename T, std::size_t N1, std::size_t N2>
+inline void batch_store(batch_block<T, N1, N2> const& src, std::size_t first, std::size_t count, matrix_batch<T, N1, N2>& dst)
+{
+    for (std::size_t i = 0; i < N1; ++i)
+    {
+        for (std::size_t j = 0; j < N2; ++j)
+        {
+            std::copy_n(src[i][j], count, dst.element(i, j) + first);
+        }
+    }
+}
+
+// Copy the flags of a block to the output flags, return true if all are set
+inline bool batch_store_flags(bool const* flags, std::size_t first, std::size_t count, bool* out)
+{
+    if (out)
+    {
+        std::copy_n(flags, count, out + first);
+    }
+    return std::all_of(flags, flags + count, [](bool f) { return f; });
+}
+
+// Partial pivoting for column i of every system in the block.
+// Rows are swapped in a tournament, after comparing against row j, row i holds
+// the largest pivot so far, which avoids tracking the pivot row of every lane.
+// The rows of c are swapped along with the rows of a.
+template<typename T, std::size_t N, std::size_t M>
+void batch_partial_pivot(batch_block<T, N, N>& a, batch_block<T, N, M>& c, std::size_t i, std::size_t count)
+{
+    using std::abs;
+
+    for (std::size_t j = i + 1; j < N; ++j)
+    {
+        for (std::size_t col = 0; col < M; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                swap_if(abs(a[j][i][k]) > abs(a[i][i][k]), c[i][col][k], c[j][col][k]);
+            }
+        }
+
+        // column i decides whether to swap, so it must be the last one swapped
+        for (std::size_t col = N; col-- > i;)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                swap_if(abs(a[j][i][k]) > abs(a[i][i][k]), a[i][col][k], a[j][col][k]);
+            }
+        }
+    }
+}
+
+// Gaussian elimination with partial pivoting, the solution is left in b
+template<typename T, std::size_t N>
+void batch_solve_block(batch_block<T, N, N>& a, batch_block<T, N, 1>& b, bool* ok, std::size_t count, T tolerance)
+{
+    T f[batch_block_size];
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        batch_partial_pivot(a, b, i, count);
+
+        // the diagonal is replaced by its inverse, which is used by the back substitution
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            a[i][i][k] = safe_invert(a[i][i][k], ok[k], tolerance);
+        }
+
+        // eliminate c[i + 1..N][i]
+        for (std::size_t row = i + 1; row < N; ++row)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                f[k] = a[row][i][k] * a[i][i][k];
+            }
+
+            for (std::size_t col = i + 1; col < N; ++col)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    a[row][col][k] -= f[k] * a[i][col][k];
+                }
+            }
+
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                b[row][0][k] -= f[k] * b[i][0][k];
+            }
+        }
+    }
+
+    // back substitution
+    for (std::size_t row = N; row--;)
+    {
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                b[row][0][k] -= a[row][col][k] * b[col][0][k];
+            }
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            b[row][0][k] *= a[row][row][k];
+        }
+    }
+}
+
+// Gauss-Jordan elimination with partial pivoting
+template<typename T, std::size_t N>
+void batch_invert_block(batch_block<T, N, N>& a, batch_block<T, N, N>& inv, bool* ok, std::size_t count, T tolerance)
+{
+    T f[batch_block_size];
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            std::fill_n(inv[i][j], count, i == j ? T(1) : T(0));
+        }
+    }
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        batch_partial_pivot(a, inv, i, count);
+
+        // scale the pivot row so that the pivot becomes 1
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            f[k] = safe_invert(a[i][i][k], ok[k], tolerance);
+        }
+
+        for (std::size_t col = i; col < N; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                a[i][col][k] *= f[k];
+            }
+        }
+
+        for (std::size_t col = 0; col < N; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                inv[i][col][k] *= f[k];
+            }
+        }
+
+        // eliminate column i of all the other rows
+        for (std::size_t row = 0; row < N; ++row)
+        {
+            if (row == i)
+            {
+                continue;
+            }
+
+            std::copy_n(a[row][i], count, f);
+
+            for (std::size_t col = i; col < N; ++col)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    a[row][col][k] -= f[k] * a[i][col][k];
+                }
+            }
+
+            for (std::size_t col = 0; col < N; ++col)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    inv[row][col][k] -= f[k] * inv[i][col][k];
+                }
+            }
+        }
+    }
+}
+
+// Cholesky decomposition in place, L is left in the lower triangular part of a
+// and the upper triangular part is cleared
+template<typename T, std::size_t N>
+void batch_cholesky_block(batch_block<T, N, N>& a, bool* ok, std::size_t count, T tolerance)
+{
+    using std::sqrt;
+
+    T inv_d[batch_block_size];
+
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        for (std::size_t p = 0; p < j; ++p)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                a[j][j][k] -= a[j][p][k] * a[j][p][k];
+            }
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            // not positive definite, keep going with a positive pivot so that the lane stays finite
+            T fail = a[j][j][k] > tolerance ? T(0) : T(1);
+            ok[k] = ok[k] & (fail == T(0));
+
+            T d = sqrt((std::max)(a[j][j][k], tolerance) + fail);
+            a[j][j][k] = d;
+            inv_d[k] = T(1) / d;
+        }
+
+        for (std::size_t i = j + 1; i < N; ++i)
+        {
+            for (std::size_t p = 0; p < j; ++p)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    a[i][j][k] -= a[i][p][k] * a[j][p][k];
+                }
+            }
+
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                a[i][j][k] *= inv_d[k];
+            }
+
+            std::fill_n(a[j][i], count, T(0));
+        }
+    }
+}
+
+// Solve L*L^T*x = b, the solution is left in b
+template<typename T, std::size_t N>
+void batch_cholesky_solve_block(batch_block<T, N, N> const& l, batch_block<T, N, 1>& b, std::size_t count)
+{
+    // solve L*y = b
+    for (std::size_t row = 0; row < N; ++row)
+    {
+        for (std::size_t col = 0; col < row; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                b[row][0][k] -= l[row][col][k] * b[col][0][k];
+            }
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            b[row][0][k] /= l[row][row][k];
+        }
+    }
+
+    // solve L^T*x = y
+    for (std::size_t row = N; row--;)
+    {
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                b[row][0][k] -= l[col][row][k] * b[col][0][k];
+            }
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            b[row][0][k] /= l[row][row][k];
+        }
+    }
+}
+
+// Apply the k-th Householder reflection stored in v to column j of c
+template<typename T, std::size_t M, std::size_t N, std::size_t C>
+void batch_householder_apply(batch_block<T, M, N> const& v, std::size_t k, batch_block<T, M, C>& c, std::size_t j, std::size_t count)
+{
+    T s[batch_block_size];
+    std::fill_n(s, count, T(0));
+
+    for (std::size_t i = k; i < M; ++i)
+    {
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            s[l] += v[i][k][l] * c[i][j][l];
+        }
+    }
+
+    // v[k][k] >= 1, see batch_least_squares_block
+    for (std::size_t l = 0; l < count; ++l)
+    {
+        s[l] = -s[l] / v[k][k][l];
+    }
+
+    for (std::size_t i = k; i < M; ++i)
+    {
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            c[i][j][l] += s[l] * v[i][k][l];
+        }
+    }
+}
+
+// Householder QR decomposition, Q^T is applied to b along the way,
+// the least squares solution is left in the first N rows of b
+template<typename T, std::size_t M, std::size_t N>
+void batch_least_squares_block(batch_block<T, M, N>& a, batch_block<T, M, 1>& b, bool* ok, std::size_t count, T tolerance)
+{
+    using std::sqrt;
+
+    T rdiag[N][batch_block_size];
+    T s[batch_block_size];
+
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        // the norm of the k-th column below the diagonal
+        std::fill_n(s, count, T(0));
+        for (std::size_t i = k; i < M; ++i)
+        {
+            for (std::size_t l = 0; l < count; ++l)
+            {
+                s[l] += a[i][k][l] * a[i][k][l];
+            }
+        }
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            T norm = sqrt(s[l]);
+
+            // rank deficient, keep going with a non zero norm so that the lane stays finite
+            T fail = is_zero(norm, tolerance) ? T(1) : T(0);
+            ok[l] = ok[l] & (fail == T(0));
+
+            // reflect to the side which avoids cancellation
+            T sign = a[k][k][l] < T(0) ? T(-1) : T(1);
+            norm = sign * (norm + fail);
+
+            rdiag[k][l] = -norm;
+            s[l] = T(1) / norm;
+        }
+
+        // form the k-th Householder vector, its first element is 1 + |a[k][k]| / norm
+        for (std::size_t i = k; i < M; ++i)
+        {
+            for (std::size_t l = 0; l < count; ++l)
+            {
+                a[i][k][l] *= s[l];
+            }
+        }
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            a[k][k][l] += T(1);
+        }
+
+        for (std::size_t j = k + 1; j < N; ++j)
+        {
+            batch_householder_apply(a, k, a, j, count);
+        }
+        batch_householder_apply(a, k, b, 0, count);
+    }
+
+    // solve R*x = Q^T*b
+    for (std::size_t row = N; row--;)
+    {
+        for (std::size_t col = row + 1; col < N; ++col)
+        {
+            for (std::size_t l = 0; l < count; ++l)
+            {
+                b[row][0][l] -= a[row][col][l] * b[col][0][l];
+            }
+        }
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            b[row][0][l] /= rdiag[row][l];
+        }
+    }
+}
+
+} // namespace detail
+
+/// Solve a batch of 2x2 linear systems a[k]*x[k] = b[k] with Cramer's rule.
+/// If ok is not null, ok[k] is set to whether the k-th system has a unique solution,
+/// the solution of a failed system is zero.
+/// Return true if all systems are solved.
+template<typename T>
+bool solve(matrix_batch<T, 2, 2> const& a, matrix_batch<T, 2, 1> const& b, matrix_batch<T, 2, 1>& x,
+           bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(a.size() == b.size());
+    x.resize(a.size());
+
+    T const* a00 = a.element(0, 0);
+    T const* a01 = a.element(0, 1);
+    T const* a10 = a.element(1, 0);
+    T const* a11 = a.element(1, 1);
+    T const* b0 = b.element(0, 0);
+    T const* b1 = b.element(1, 0);
+    T* x0 = x.element(0, 0);
+    T* x1 = x.element(1, 0);
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t k = first + i;
+            T det = a00[k] * a11[k] - a10[k] * a01[k];
+            T inv_det = detail::safe_invert(det, flags[i], tolerance);
+
+            x0[k] = (b0[k] * a11[k] - b1[k] * a01[k]) * inv_det;
+            x1[k] = (a00[k] * b1[k] - a10[k] * b0[k]) * inv_det;
+        }
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Solve a batch of 3x3 linear systems a[k]*x[k] = b[k] with Cramer's rule.
+/// If ok is not null, ok[k] is set to whether the k-th system has a unique solution,
+/// the solution of a failed system is zero.
+/// Return true if all systems are solved.
+template<typename T>
+bool solve(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 1> const& b, matrix_batch<T, 3, 1>& x,
+           bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(a.size() == b.size());
+    x.resize(a.size());
+
+    T const* a00 = a.element(0, 0);
+    T const* a01 = a.element(0, 1);
+    T const* a02 = a.element(0, 2);
+    T const* a10 = a.element(1, 0);
+    T const* a11 = a.element(1, 1);
+    T const* a12 = a.element(1, 2);
+    T const* a20 = a.element(2, 0);
+    T const* a21 = a.element(2, 1);
+    T const* a22 = a.element(2, 2);
+    T const* b0 = b.element(0, 0);
+    T const* b1 = b.element(1, 0);
+    T const* b2 = b.element(2, 0);
+    T* x0 = x.element(0, 0);
+    T* x1 = x.element(1, 0);
+    T* x2 = x.element(2, 0);
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t k = first + i;
+
+            // the adjoint matrix
+            T i00 = a11[k] * a22[k] - a12[k] * a21[k];
+            T i01 = a02[k] * a21[k] - a01[k] * a22[k];
+            T i02 = a01[k] * a12[k] - a02[k] * a11[k];
+            T i10 = a12[k] * a20[k] - a10[k] * a22[k];
+            T i11 = a00[k] * a22[k] - a02[k] * a20[k];
+            T i12 = a02[k] * a10[k] - a00[k] * a12[k];
+            T i20 = a10[k] * a21[k] - a11[k] * a20[k];
+            T i21 = a01[k] * a20[k] - a00[k] * a21[k];
+            T i22 = a00[k] * a11[k] - a01[k] * a10[k];
+
+            T det = a00[k] * i00 + a01[k] * i10 + a02[k] * i20;
+            T inv_det = detail::safe_invert(det, flags[i], tolerance);
+
+            x0[k] = (b0[k] * i00 + b1[k] * i01 + b2[k] * i02) * inv_det;
+            x1[k] = (b0[k] * i10 + b1[k] * i11 + b2[k] * i12) * inv_det;
+            x2[k] = (b0[k] * i20 + b1[k] * i21 + b2[k] * i22) * inv_det;
+        }
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Solve a batch of linear systems a[k]*x[k] = b[k] using Gaussian elimination with partial pivoting.
+/// If ok is not null, ok[k] is set to whether the k-th system has a unique solution,
+/// the solution of a failed system is unspecified.
+/// Return true if all systems are solved.
+template<typename T, std::size_t N>
+bool solve_partial_pivoting(matrix_batch<T, N, N> const& a, matrix_batch<T, N, 1> const& b, matrix_batch<T, N, 1>& x,
+                            bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(a.size() == b.size());
+    x.resize(a.size());
+
+    detail::batch_block<T, N, N> work_a;
+    detail::batch_block<T, N, 1> work_b;
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        detail::batch_load(a, first, count, work_a);
+        detail::batch_load(b, first, count, work_b);
+        detail::batch_solve_block(work_a, work_b, flags, count, tolerance);
+        detail::batch_store(work_b, first, count, x);
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Cholesky decompose a batch of symmetric positive definite matrices, see cholesky_decompose.
+/// If ok is not null, ok[k] is set to whether the k-th matrix is positive definite,
+/// the decomposition of a failed matrix is unspecified.
+/// Return true if all matrices are decomposed.
+template<typename T, std::size_t N>
+bool cholesky_decompose(matrix_batch<T, N, N> const& a, matrix_batch<T, N, N>& l,
+                        bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    l.resize(a.size());
+
+    detail::batch_block<T, N, N> work;
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        detail::batch_load(a, first, count, work);
+        detail::batch_cholesky_block(work, flags, count, tolerance);
+        detail::batch_store(work, first, count, l);
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Solve a batch of linear systems a[k]*x[k] = b[k], where l is the result of cholesky_decompose
+template<typename T, std::size_t N>
+void cholesky_solve(matrix_batch<T, N, N> const& l, matrix_batch<T, N, 1> const& b, matrix_batch<T, N, 1>& x)
+{
+    KISMET_ASSERT(l.size() == b.size());
+    x.resize(l.size());
+
+    detail::batch_block<T, N, N> work_l;
+    detail::batch_block<T, N, 1> work_b;
+
+    for (std::size_t first = 0; first < l.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, l.size() - first);
+
+        detail::batch_load(l, first, count, work_l);
+        detail::batch_load(b, first, count, work_b);
+        detail::batch_cholesky_solve_block(work_l, work_b, count);
+        detail::batch_store(work_b, first, count, x);
+    }
+}
+
+/// Solve a batch of linear systems a[k]*x[k] = b[k] using Cholesky decomposition,
+/// a[k] must be symmetric positive definite.
+/// If ok is not null, ok[k] is set to whether the k-th matrix is positive definite,
+/// the solution of a failed system is unspecified.
+/// Return true if all systems are solved.
+template<typename T, std::size_t N>
+bool solve_cholesky(matrix_batch<T, N, N> const& a, matrix_batch<T, N, 1> const& b, matrix_batch<T, N, 1>& x,
+                    bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(a.size() == b.size());
+    x.resize(a.size());
+
+    detail::batch_block<T, N, N> work_a;
+    detail::batch_block<T, N, 1> work_b;
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        detail::batch_load(a, first, count, work_a);
+        detail::batch_load(b, first, count, work_b);
+        detail::batch_cholesky_block(work_a, flags, count, tolerance);
+        detail::batch_cholesky_solve_block(work_a, work_b, count);
+        detail::batch_store(work_b, first, count, x);
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Solve a batch of linear systems a[k]*x[k] = b[k] in the least squares sense using
+/// Householder QR decomposition, a[k] is a MxN matrix where M >= N.
+/// If ok is not null, ok[k] is set to whether the k-th matrix has full column rank,
+/// the solution of a failed system is unspecified.
+/// Return true if all systems are solved.
+template<typename T, std::size_t M, std::size_t N>
+bool solve_least_squares(matrix_batch<T, M, N> const& a, matrix_batch<T, M, 1> const& b, matrix_batch<T, N, 1>& x,
+                         bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    static_assert(M >= N, "the matrices must have at least as many rows as columns");
+    KISMET_ASSERT(a.size() == b.size());
+    x.resize(a.size());
+
+    detail::batch_block<T, M, N> work_a;
+    detail::batch_block<T, M, 1> work_b;
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        detail::batch_load(a, first, count, work_a);
+        detail::batch_load(b, first, count, work_b);
+        detail::batch_least_squares_block(work_a, work_b, flags, count, tolerance);
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            std::copy_n(work_b[i][0], count, x.element(i, 0) + first);
+        }
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Calculate the inverse of a batch of matrices using Gauss-Jordan elimination with partial pivoting.
+/// If ok is not null, ok[k] is set to whether the k-th matrix is invertible,
+/// the inverse of a non-invertible matrix is unspecified.
+/// Return true if all matrices are invertible.
+template<typename T, std::size_t N>
+bool invert(matrix_batch<T, N, N> const& a, matrix_batch<T, N, N>& inverse,
+            bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    inverse.resize(a.size());
+
+    detail::batch_block<T, N, N> work_a;
+    detail::batch_block<T, N, N> work_inv;
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        detail::batch_load(a, first, count, work_a);
+        detail::batch_invert_block(work_a, work_inv, flags, count, tolerance);
+        detail::batch_store(work_inv, first, count, inverse);
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+/// Calculate the inverse of a batch of 3x3 matrices using the adjoint matrix.
+/// If ok is not null, ok[k] is set to whether the k-th matrix is invertible,
+/// the inverse of a non-invertible matrix is zero.
+/// Return true if all matrices are invertible.
+template<typename T>
+bool invert(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& inverse,
+            bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(&a != &inverse);
+    inverse.resize(a.size());
+
+    T const* a00 = a.element(0, 0);
+    T const* a01 = a.element(0, 1);
+    T const* a02 = a.element(0, 2);
+    T const* a10 = a.element(1, 0);
+    T const* a11 = a.element(1, 1);
+    T const* a12 = a.element(1, 2);
+    T const* a20 = a.element(2, 0);
+    T const* a21 = a.element(2, 1);
+    T const* a22 = a.element(2, 2);
+    T* r00 = inverse.element(0, 0);
+    T* r01 = inverse.element(0, 1);
+    T* r02 = inverse.element(0, 2);
+    T* r10 = inverse.element(1, 0);
+    T* r11 = inverse.element(1, 1);
+    T* r12 = inverse.element(1, 2);
+    T* r20 = inverse.element(2, 0);
+    T* r21 = inverse.element(2, 1);
+    T* r22 = inverse.element(2, 2);
+
+    bool all_ok = true;
+    bool flags[detail::batch_block_size];
+    for (std::size_t first = 0; first < a.size(); first += detail::batch_block_size)
+    {
+        std::size_t count = (std::min)(detail::batch_block_size, a.size() - first);
+        std::fill_n(flags, count, true);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t k = first + i;
+
+            // the adjoint matrix
+            T i00 = a11[k] * a22[k] - a12[k] * a21[k];
+            T i01 = a02[k] * a21[k] - a01[k] * a22[k];
+            T i02 = a01[k] * a12[k] - a02[k] * a11[k];
+            T i10 = a12[k] * a20[k] - a10[k] * a22[k];
+            T i11 = a00[k] * a22[k] - a02[k] * a20[k];
+            T i12 = a02[k] * a10[k] - a00[k] * a12[k];
+            T i20 = a10[k] * a21[k] - a11[k] * a20[k];
+            T i21 = a01[k] * a20[k] - a00[k] * a21[k];
+            T i22 = a00[k] * a11[k] - a01[k] * a10[k];
+
+            T det = a00[k] * i00 + a01[k] * i10 + a02[k] * i20;
+            T inv_det = detail::safe_invert(det, flags[i], tolerance);
+
+            r00[k] = i00 * inv_det;
+            r01[k] = i01 * inv_det;
+            r02[k] = i02 * inv_det;
+            r10[k] = i10 * inv_det;
+            r11[k] = i11 * inv_det;
+            r12[k] = i12 * inv_det;
+            r20[k] = i20 * inv_det;
+            r21[k] = i21 * inv_det;
+            r22[k] = i22 * inv_det;
+        }
+
+        all_ok = detail::batch_store_flags(flags, first, count, ok) && all_ok;
+    }
+    return all_ok;
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_LINEAR_SYSTEM_BATCH_H
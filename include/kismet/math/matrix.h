@@ -971,18 +971,9 @@ public:
 
     matrix& operator *=(matrix<T, N2, N2> const& rhs)
     {
+        // the product can't be written into *this while *this is read
         matrix tmp;
-        for (std::size_t i = 0; i < N1; ++i)
-        {
-            for (std::size_t j = 0; j < N2; ++j)
-            {
-                tmp[i][j] = T(0);
-                for (std::size_t k = 0; k < N2; ++k)
-                {
-                    tmp[i][j] += m_a[i][k] * rhs.m_a[k][j];
-                }
-            }
-        }
+        multiply_into(tmp, *this, rhs);
         *this = tmp;
         return *this;
     }
@@ -1125,9 +1116,97 @@ inline matrix<T, N2, N1> transpose(matrix<T, N1, N2> const& m)
     return t;
 }
 
+/// Transpose a square matrix in place, which saves the copy of transpose when the
+/// original is no longer needed
+template<typename T, std::size_t N>
+inline void transpose_inplace(matrix<T, N, N>& m)
+{
+    using std::swap;
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            swap(m[i][j], m[j][i]);
+        }
+    }
+}
+
 namespace detail
 {
 
+// Return the sign of the permutation represented by p, i.e. (-1)^(number of transpositions)
+template<std::size_t N>
+int permutation_sign(std::size_t const (&p)[N])
+{
+    bool visited[N] = {};
+    int sign = 1;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (visited[i])
+        {
+            continue;
+        }
+
+        // a cycle of length k is k - 1 transpositions
+        for (std::size_t j = p[i]; j != i; j = p[j])
+        {
+            visited[j] = true;
+            sign = -sign;
+        }
+        visited[i] = true;
+    }
+    return sign;
+}
+
+template<typename T, std::size_t N>
+struct det_impl
+{
+    static T calc(matrix<T, N, N> const& a, T tolerance)
+    {
+        matrix<T, N, N> lu;
+        std::size_t p[N];
+        plu_decompose_packed(a, p, lu, tolerance);
+
+        // det(A) = det(P)*det(L)*det(U), where det(L) = 1
+        T det = T(permutation_sign(p));
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            det *= lu[i][i];
+        }
+        return det;
+    }
+};
+
+template<typename T>
+struct det_impl<T, 1>
+{
+    static T calc(matrix<T, 1, 1> const& a, T)
+    {
+        return a[0][0];
+    }
+};
+
+template<typename T>
+struct det_impl<T, 2>
+{
+    static T calc(matrix<T, 2, 2> const& a, T)
+    {
+        return a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    }
+};
+
+template<typename T>
+struct det_impl<T, 3>
+{
+    static T calc(matrix<T, 3, 3> const& a, T)
+    {
+        return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+             + a[0][1] * (a[1][2] * a[2][0] - a[1][0] * a[2][2])
+             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    }
+};
+
 template<typename T, std::size_t N>
 struct inv_impl
 {
@@ -1135,50 +1214,81 @@ struct inv_impl
 
     static bool calc(matrix_type const& a, matrix_type& inverse, T tolerance)
     {
-        matrix_type l, u;
-        std::size_t perm[N];
-
-        plu_decompose(a, perm, l, u, tolerance);
-        inverse.clear();
-        // To calculate the inverse matrix A^-1, we can solve N linear systems which are of form
-        //    A*xi = ei
-        // where xi is the i-th column of the inverse matrix,
-        // ei is the i-th column of the identity matrix.
-        // Since
-        //    A = PLU
-        // we need to solve
-        //    PLU*xi = ei
-        matrix<T, N, 1> solution;
-        for (std::size_t i = 0; i < N; ++i)
+        using std::size_t;
+
+        // A = P*L*U, so A^-1 = U^-1 * L^-1 * P^T.
+        // Both triangular factors are inverted in place in the packed matrix.
+        matrix_type lu;
+        size_t perm[N];
+        plu_decompose_packed(a, perm, lu, tolerance);
+
+        T* m = lu.data();
+        for (size_t i = 0; i < N; ++i)
         {
-            auto col = inverse.column(i);
-            solution = col;
-
-            using std::begin;
-            using std::end;
-            // let zi = LU*xi
-            // solve P*zi = ei
-            // we need to find the position of e[i][i] after permutation
-            // we have zi = P^-1 * ei = P^T * ei
-            // since we know p[m][p[m]] = 1, so to find j where
-            // P^T[j][i] = 1, we can simply find j where
-            // P[i][j] = 1, which means j = p[i].
-            solution[perm[i]] = T(1);
-
-            // let yi = U*xi
-            // solve L*yi = zi
-            if (!forward_substitute(l, solution, solution, tolerance))
+            if (is_zero(m[i * N + i], tolerance))
             {
                 return false;
             }
+        }
+
+        // invert U column by column, the leading block is already inverted
+        //   U^-1[0..j][j] = -U^-1[0..j][0..j] * U[0..j][j] / U[j][j]
+        for (size_t j = 0; j < N; ++j)
+        {
+            T inv_diag = invert(m[j * N + j]);
+            m[j * N + j] = inv_diag;
 
-            // solve U*xi = yi
-            if (!backward_substitute(u, solution, solution, tolerance))
+            // top down, so that U[k][j] for k > i is still the original
+            for (size_t i = 0; i < j; ++i)
             {
-                return false;
+                T v(0);
+                for (size_t k = i; k < j; ++k)
+                {
+                    v += m[i * N + k] * m[k * N + j];
+                }
+                m[i * N + j] = -v * inv_diag;
             }
+        }
 
-            col = solution;
+        // invert the unit L column by column from the right, the trailing block is already inverted
+        //   L^-1[j + 1..N][j] = -L^-1[j + 1..N][j + 1..N] * L[j + 1..N][j]
+        for (size_t j = N - 1; j--;)
+        {
+            // bottom up, so that L[k][j] for k < i is still the original
+            for (size_t i = N - 1; i > j; --i)
+            {
+                T v(m[i * N + j]);
+                for (size_t k = j + 1; k < i; ++k)
+                {
+                    v += m[i * N + k] * m[k * N + j];
+                }
+                m[i * N + j] = -v;
+            }
+        }
+
+        // row i of U^-1 * L^-1, then permute the columns by P^T
+        //   (M*P^T)[i][r] = M[i][p[r]]
+        T row[N];
+        for (size_t i = 0; i < N; ++i)
+        {
+            T const* ui = m + i * N;
+            for (size_t j = 0; j < N; ++j)
+            {
+                // U^-1[i][k] is zero for k < i, L^-1[k][j] is zero for k < j and one for k == j
+                size_t k = (std::max)(i, j);
+                T v = k == j ? ui[k] : ui[k] * m[k * N + j];
+                for (++k; k < N; ++k)
+                {
+                    v += ui[k] * m[k * N + j];
+                }
+                row[j] = v;
+            }
+
+            T* out = inverse.data() + i * N;
+            for (size_t r = 0; r < N; ++r)
+            {
+                out[r] = row[perm[r]];
+            }
         }
 
         return true;
@@ -1190,13 +1300,13 @@ struct inv_impl<T, 1>
 {
     using matrix_type = matrix<T, 1, 1>;
 
-    static bool calc(matrix_type a, matrix_type& inverse, T tolerance)
+    static bool calc(matrix_type const& a, matrix_type& inverse, T tolerance)
     {
-        if (is_zero(a[0], tolerance))
+        if (is_zero(T(a[0][0]), tolerance))
         {
             return false;
         }
-        a[0] = invert(a[0]);
+        inverse[0][0] = invert(T(a[0][0]));
         return true;
     }
 };
@@ -1256,6 +1366,14 @@ struct inv_impl<T, 3>
 
 } // namespace detail
 
+/// Calculate the determinant of the matrix,
+/// matrices larger than 3x3 use the diagonal of the PLU decomposition
+template<typename T, std::size_t N>
+inline T determinant(matrix<T, N, N> const& a, T tolerance = math_trait<T>::zero_tolerance())
+{
+    return detail::det_impl<T, N>::calc(a, tolerance);
+}
+
 /// Calculate the inverse of the matrix using PLU decomposition
 /// Return true if the matrix is invertible
 /// NOTE: whether inverse is modified on failure is unspecified.
@@ -1274,90 +1392,108 @@ inline matrix<T, N, N> invert(matrix<T, N, N> const& a, T tolerance = math_trait
     return invert(a, inverse, tolerance) ? inverse : a;
 }
 
+// The arithmetic operators compute into the returned matrix, which is constructed in place
+// of the caller's result, instead of copying an operand and updating the copy. matrix has
+// no storage to steal, so taking an operand by value or by rvalue reference would still
+// copy all of its elements.
+
 template<typename T, std::size_t N1, std::size_t N2>
-inline matrix<T, N1, N2> operator +(matrix<T, N1, N2> m1, matrix<T, N1, N2> const& m2)
+inline matrix<T, N1, N2> operator +(matrix<T, N1, N2> const& m1, matrix<T, N1, N2> const& m2)
 {
-    return m1 += m2;
+    matrix<T, N1, N2> res;
+    T const* a = m1.data();
+    T const* b = m2.data();
+    T* r = res.data();
+    for (std::size_t i = 0; i < N1 * N2; ++i)
+    {
+        r[i] = a[i] + b[i];
+    }
+    return res;
 }
 
 template<typename T, std::size_t N1, std::size_t N2>
-inline matrix<T, N1, N2> operator -(matrix<T, N1, N2> m1, matrix<T, N1, N2> const& m2)
+inline matrix<T, N1, N2> operator -(matrix<T, N1, N2> const& m1, matrix<T, N1, N2> const& m2)
 {
-    return m1 -= m2;
+    matrix<T, N1, N2> res;
+    T const* a = m1.data();
+    T const* b = m2.data();
+    T* r = res.data();
+    for (std::size_t i = 0; i < N1 * N2; ++i)
+    {
+        r[i] = a[i] - b[i];
+    }
+    return res;
 }
 
 // return a matrix with element is common type of scalar and matrix's element type
 template<typename U, typename T, std::size_t N1, std::size_t N2>
 inline matrix<std::common_type_t<U, T>, N1, N2> operator *(U k, matrix<T, N1, N2> const& m)
 {
-    matrix<std::common_type_t<U, T>, N1, N2> res{m};
-    res *= k;
-    return res;
-}
+    using C = std::common_type_t<U, T>;
 
-// TODO: do we need this for performance reason, in case that generic scalar multiplication version
-// cannot optimize for rvalue ?
-template<typename T, std::size_t N1, std::size_t N2>
-inline matrix<T, N1, N2> operator *(T k, matrix<T, N1, N2> m)
-{
-    m *= k;
-    return m;
+    matrix<C, N1, N2> res;
+    T const* a = m.data();
+    C* r = res.data();
+    for (std::size_t i = 0; i < N1 * N2; ++i)
+    {
+        r[i] = C(a[i]) * C(k);
+    }
+    return res;
 }
 
 // return a matrix with element is common type of scalar and matrix's element type
 template<typename U, typename T, std::size_t N1, std::size_t N2>
 inline matrix<std::common_type_t<U, T>, N1, N2> operator *(matrix<T, N1, N2> const& m, U k)
 {
-    matrix<std::common_type_t<U, T>, N1, N2> res{m};
-    res *= k;
-    return res;
-}
-
-// TODO: do we need this for performance reason, in case that generic scalar multiplication version
-// cannot optimize for rvalue ?
-template<typename T, std::size_t N1, std::size_t N2>
-inline matrix<T, N1, N2> operator *(matrix<T, N1, N2> m, T k)
-{
-    m *= k;
-    return m;
+    return k * m;
 }
 
 template<typename U, typename T, std::size_t N1, std::size_t N2>
 inline matrix<std::common_type_t<U, T>, N1, N2> operator /(matrix<T, N1, N2> const& m, U k)
 {
-    matrix<std::common_type_t<U, T>, N1, N2> res{m};
-    res /= k;
-    return res;
-}
+    using C = std::common_type_t<U, T>;
 
-// TODO: do we need this for performance reason, in case that generic scalar multiplication version
-// cannot optimize for rvalue ?
-template<typename T, std::size_t N1, std::size_t N2>
-inline matrix<T, N1, N2> operator /(matrix<T, N1, N2> m, T k)
-{
-    m /= k;
-    return m;
+    KISMET_ASSERT(!is_zero(C(k)));
+    return invert(C(k)) * m;
 }
 
 /// Matrix multiplication
-///    M1 * M2
+///    dst = M1 * M2
 /// M1 which is N1 by N2
 /// M2 which is N2 by N3
+/// The product is written to dst directly, without the temporary of operator *, which is
+/// copied when it is assigned to an existing matrix. dst must not refer to M1 or M2.
 template<typename T, std::size_t N1, std::size_t N2, std::size_t N3>
-inline matrix<T, N1, N3> operator *(matrix<T, N1, N2> const& m1, matrix<T, N2, N3> const& m2)
+inline void multiply_into(matrix<T, N1, N3>& dst, matrix<T, N1, N2> const& m1, matrix<T, N2, N3> const& m2)
 {
-    matrix<T, N1, N3> res;
+    KISMET_ASSERT(static_cast<void const*>(&dst) != &m1 && static_cast<void const*>(&dst) != &m2);
+
+    T const* a = m1.data();
+    T const* b = m2.data();
+    T* d = dst.data();
     for (std::size_t i = 0; i < N1; ++i)
     {
         for (std::size_t j = 0; j < N3; ++j)
         {
-            res[i][j] = T(0);
+            T v(0);
             for (std::size_t k = 0; k < N2; ++k)
             {
-                res[i][j] += m1[i][k] * m2[k][j];
+                v += a[i * N2 + k] * b[k * N3 + j];
             }
+            d[i * N3 + j] = v;
         }
     }
+}
+
+/// Matrix multiplication
+///    M1 * M2
+/// M1 which is N1 by N2
+/// M2 which is N2 by N3
+template<typename T, std::size_t N1, std::size_t N2, std::size_t N3>
+inline matrix<T, N1, N3> operator *(matrix<T, N1, N2> const& m1, matrix<T, N2, N3> const& m2)
+{
+    matrix<T, N1, N3> res;
+    multiply_into(res, m1, m2);
     return res;
 }
 
@@ -0,0 +1,102 @@
+#ifndef KISMET_MATH_MATRIX_BATCH_H
+#define KISMET_MATH_MATRIX_BATCH_H
+
+#include <cstddef>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/detail/soa_storage.h"
+#include "kismet/math/matrix.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A batch of N1xN2 matrices stored as a structure of arrays.
+/// The same element of all matrices is contiguous, element (i, j) of the k-th matrix
+/// is element(i, j)[k], so batch kernels work on one matrix per SIMD lane.
+template<typename T, std::size_t N1, std::size_t N2>
+class matrix_batch
+{
+    static_assert(detail::valid_dimension<N1, N2>::value, "Dimension must not be 0");
+public:
+    using size_type       = std::size_t;
+    using value_type      = T;
+    using pointer         = T*;
+    using const_pointer   = T const*;
+    using matrix_type     = matrix<T, N1, N2>;
+
+    enum { rank = 2, num = N1 * N2 };
+
+    matrix_batch() = default;
+
+    explicit matrix_batch(size_type n)
+        : m_storage(n)
+    {
+    }
+
+    // Return the number of matrices
+    size_type size() const { return m_storage.size(); }
+
+    bool empty() const { return size() == 0; }
+
+    // Resize the batch, existing matrices are preserved, new matrices are zero
+    void resize(size_type n) { m_storage.resize(n); }
+
+    // Return the distance between the arrays of two adjacent elements,
+    // which is size() padded to a multiple of SIMD lanes
+    size_type stride() const { return m_storage.stride(); }
+
+    // Return the array of element (i, j) of all matrices
+    pointer element(size_type i, size_type j)
+    {
+        KISMET_ASSERT(i < N1 && j < N2);
+        return m_storage.component(i * N2 + j);
+    }
+
+    const_pointer element(size_type i, size_type j) const
+    {
+        KISMET_ASSERT(i < N1 && j < N2);
+        return m_storage.component(i * N2 + j);
+    }
+
+    // Return the k-th matrix
+    matrix_type get(size_type k) const
+    {
+        KISMET_ASSERT(k < size());
+        matrix_type m;
+        for (size_type i = 0; i < num; ++i)
+        {
+            m.data()[i] = m_storage.component(i)[k];
+        }
+        return m;
+    }
+
+    // Replace the k-th matrix
+    void set(size_type k, matrix_type const& m)
+    {
+        KISMET_ASSERT(k < size());
+        for (size_type i = 0; i < num; ++i)
+        {
+            m_storage.component(i)[k] = m.data()[i];
+        }
+    }
+
+    void swap(matrix_batch& rhs)
+    {
+        m_storage.swap(rhs.m_storage);
+    }
+private:
+    detail::soa_storage<T, num> m_storage;
+};
+
+template<typename T, std::size_t N1, std::size_t N2>
+inline void swap(matrix_batch<T, N1, N2>& lhs, matrix_batch<T, N1, N2>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_MATRIX_BATCH_H
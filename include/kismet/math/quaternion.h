@@ -130,13 +130,13 @@ public:
         return q;
     }
 
-    // left multiply a quaternion
+    // right multiply a quaternion, i.e. *this = *this * rhs
     quaternion& operator *=(quaternion const& rhs)
     {
         T w0 = w() * rhs.w() - x() * rhs.x() - y() * rhs.y() - z() * rhs.z();
-        T x0 = w() * rhs.x() - rhs.w() * x() + y() * rhs.z() - z() * rhs.y();
-        T y0 = w() * rhs.y() - rhs.w() * y() + z() * rhs.x() - x() * rhs.z();
-        T z0 = w() * rhs.z() - rhs.w() * z() + x() * rhs.y() - y() * rhs.x();
+        T x0 = w() * rhs.x() + rhs.w() * x() + y() * rhs.z() - z() * rhs.y();
+        T y0 = w() * rhs.y() + rhs.w() * y() + z() * rhs.x() - x() * rhs.z();
+        T z0 = w() * rhs.z() + rhs.w() * z() + x() * rhs.y() - y() * rhs.x();
 
         w() = w0;
         x() = x0;
@@ -145,6 +145,30 @@ public:
         return *this;
     }
 
+    quaternion& operator +=(quaternion const& rhs)
+    {
+        v[0] += rhs.v[0];
+        v[1] += rhs.v[1];
+        v[2] += rhs.v[2];
+        v[3] += rhs.v[3];
+        return *this;
+    }
+
+    quaternion& operator -=(quaternion const& rhs)
+    {
+        v[0] -= rhs.v[0];
+        v[1] -= rhs.v[1];
+        v[2] -= rhs.v[2];
+        v[3] -= rhs.v[3];
+        return *this;
+    }
+
+    quaternion& operator *=(T k)
+    {
+        scale(k);
+        return *this;
+    }
+
     // w: 0, x: 1, y: 2, z:3
     T& operator [](std::size_t index)
     {
@@ -0,0 +1,457 @@
+#ifndef KISMET_MATH_QUATERNION_STREAM_H
+#define KISMET_MATH_QUATERNION_STREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/detail/soa_storage.h"
+#include "kismet/math/quaternion.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A stream of quaternions stored as a structure of arrays,
+/// the component arrays are in the order of quaternion's storage: w, x, y, z.
+/// The layout and padding rules are the same as vector_stream.
+template<typename T>
+class quaternion_stream
+{
+public:
+    using size_type       = std::size_t;
+    using value_type      = T;
+    using pointer         = T*;
+    using const_pointer   = T const*;
+    using quaternion_type = quaternion<T>;
+
+    quaternion_stream() = default;
+
+    explicit quaternion_stream(size_type n)
+        : m_storage(n)
+    {
+    }
+
+    /// Construct from a range of quaternion<T>
+    template<typename InputIt>
+    quaternion_stream(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    // Return the number of quaternions
+    size_type size() const { return m_storage.size(); }
+
+    bool empty() const { return size() == 0; }
+
+    // Resize the stream, existing quaternions are preserved, new quaternions are zero
+    void resize(size_type n) { m_storage.resize(n); }
+
+    // Return the size of the component arrays including the zero padding
+    size_type stride() const { return m_storage.stride(); }
+
+    pointer w() { return m_storage.component(0); }
+    pointer x() { return m_storage.component(1); }
+    pointer y() { return m_storage.component(2); }
+    pointer z() { return m_storage.component(3); }
+
+    const_pointer w() const { return m_storage.component(0); }
+    const_pointer x() const { return m_storage.component(1); }
+    const_pointer y() const { return m_storage.component(2); }
+    const_pointer z() const { return m_storage.component(3); }
+
+    // Replace the content with a range of quaternion<T>
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        resize(static_cast<size_type>(std::distance(first, last)));
+        for (size_type k = 0; first != last; ++first, ++k)
+        {
+            set(k, *first);
+        }
+    }
+
+    // Copy all quaternions to out as quaternion<T>
+    template<typename OutputIt>
+    OutputIt copy_to(OutputIt out) const
+    {
+        for (size_type k = 0; k < size(); ++k, ++out)
+        {
+            *out = get(k);
+        }
+        return out;
+    }
+
+    // Return the k-th quaternion
+    quaternion_type get(size_type k) const
+    {
+        KISMET_ASSERT(k < size());
+        return quaternion_type(w()[k], x()[k], y()[k], z()[k]);
+    }
+
+    // Replace the k-th quaternion
+    void set(size_type k, quaternion_type const& q)
+    {
+        KISMET_ASSERT(k < size());
+        w()[k] = q.w();
+        x()[k] = q.x();
+        y()[k] = q.y();
+        z()[k] = q.z();
+    }
+
+    void swap(quaternion_stream& rhs)
+    {
+        m_storage.swap(rhs.m_storage);
+    }
+private:
+    detail::soa_storage<T, 4> m_storage;
+};
+
+template<typename T>
+inline void swap(quaternion_stream<T>& lhs, quaternion_stream<T>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+// As the bulk vector operations, the functions below resize the output stream and
+// the output may refer to one of the inputs. Results of a block go through local
+// arrays, so that the compiler does not need runtime alias checks between the arrays.
+// Unlike the single element operator *, the quaternions are not checked to be unit.
+
+/// Rotate the vectors of v by the unit quaternion q
+template<typename T>
+void rotate(quaternion<T> const& q, vector_stream<T, 3> const& v, vector_stream<T, 3>& out)
+{
+    out.resize(v.size());
+
+    // every vector is rotated by the same matrix, 9 multiplications per vector
+    T xx = q.x() * q.x();
+    T yy = q.y() * q.y();
+    T zz = q.z() * q.z();
+    T xy = q.x() * q.y();
+    T xz = q.x() * q.z();
+    T yz = q.y() * q.z();
+    T wx = q.w() * q.x();
+    T wy = q.w() * q.y();
+    T wz = q.w() * q.z();
+
+    T m00 = T(1) - T(2) * (yy + zz);
+    T m01 = T(2) * (xy - wz);
+    T m02 = T(2) * (xz + wy);
+    T m10 = T(2) * (xy + wz);
+    T m11 = T(1) - T(2) * (xx + zz);
+    T m12 = T(2) * (yz - wx);
+    T m20 = T(2) * (xz - wy);
+    T m21 = T(2) * (yz + wx);
+    T m22 = T(1) - T(2) * (xx + yy);
+
+    T const* vx = v.component(0);
+    T const* vy = v.component(1);
+    T const* vz = v.component(2);
+    T* ox = out.component(0);
+    T* oy = out.component(1);
+    T* oz = out.component(2);
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = v.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            rx[l] = m00 * vx[k] + m01 * vy[k] + m02 * vz[k];
+            ry[l] = m10 * vx[k] + m11 * vy[k] + m12 * vz[k];
+            rz[l] = m20 * vx[k] + m21 * vy[k] + m22 * vz[k];
+        }
+
+        std::copy_n(rx, lanes, ox + first);
+        std::copy_n(ry, lanes, oy + first);
+        std::copy_n(rz, lanes, oz + first);
+    }
+}
+
+/// Rotate the k-th vector of v by the k-th unit quaternion of q
+template<typename T>
+void rotate(quaternion_stream<T> const& q, vector_stream<T, 3> const& v, vector_stream<T, 3>& out)
+{
+    KISMET_ASSERT(q.size() == v.size());
+    out.resize(v.size());
+
+    T const* qw = q.w();
+    T const* qx = q.x();
+    T const* qy = q.y();
+    T const* qz = q.z();
+    T const* vx = v.component(0);
+    T const* vy = v.component(1);
+    T const* vz = v.component(2);
+    T* ox = out.component(0);
+    T* oy = out.component(1);
+    T* oz = out.component(2);
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = v.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            // v' = v + w*t + q.xyz x t, where t = 2 * q.xyz x v
+            T tx = T(2) * (qy[k] * vz[k] - qz[k] * vy[k]);
+            T ty = T(2) * (qz[k] * vx[k] - qx[k] * vz[k]);
+            T tz = T(2) * (qx[k] * vy[k] - qy[k] * vx[k]);
+
+            rx[l] = vx[k] + qw[k] * tx + (qy[k] * tz - qz[k] * ty);
+            ry[l] = vy[k] + qw[k] * ty + (qz[k] * tx - qx[k] * tz);
+            rz[l] = vz[k] + qw[k] * tz + (qx[k] * ty - qy[k] * tx);
+        }
+
+        std::copy_n(rx, lanes, ox + first);
+        std::copy_n(ry, lanes, oy + first);
+        std::copy_n(rz, lanes, oz + first);
+    }
+}
+
+/// Calculate the products a[k] * b[k]
+template<typename T>
+void multiply(quaternion_stream<T> const& a, quaternion_stream<T> const& b, quaternion_stream<T>& out)
+{
+    KISMET_ASSERT(a.size() == b.size());
+    out.resize(a.size());
+
+    T const* aw = a.w();
+    T const* ax = a.x();
+    T const* ay = a.y();
+    T const* az = a.z();
+    T const* bw = b.w();
+    T const* bx = b.x();
+    T const* by = b.y();
+    T const* bz = b.z();
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = a.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T rw[lanes];
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            rw[l] = aw[k] * bw[k] - ax[k] * bx[k] - ay[k] * by[k] - az[k] * bz[k];
+            rx[l] = aw[k] * bx[k] + ax[k] * bw[k] + ay[k] * bz[k] - az[k] * by[k];
+            ry[l] = aw[k] * by[k] + ay[k] * bw[k] + az[k] * bx[k] - ax[k] * bz[k];
+            rz[l] = aw[k] * bz[k] + az[k] * bw[k] + ax[k] * by[k] - ay[k] * bx[k];
+        }
+
+        std::copy_n(rw, lanes, out.w() + first);
+        std::copy_n(rx, lanes, out.x() + first);
+        std::copy_n(ry, lanes, out.y() + first);
+        std::copy_n(rz, lanes, out.z() + first);
+    }
+}
+
+namespace detail
+{
+
+// out[k] = normalize(w0 * q0[k] + w1 * q1[k]), where weights(t, c, w0, w1) computes the weights
+// from the interpolation factor t and the cosine c >= 0 of the angle between q0[k] and q1[k].
+// q1[k] is negated if the cosine is negative, so that the interpolation takes the shortest path.
+// t is either shared or an array of q0.size() elements.
+template<typename T, typename Weights>
+void blend_quaternions(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1,
+                       T shared_t, T const* t, quaternion_stream<T>& out, Weights weights)
+{
+    using std::copysign;
+    using std::sqrt;
+
+    KISMET_ASSERT(q0.size() == q1.size());
+    out.resize(q0.size());
+
+    T const* aw = q0.w();
+    T const* ax = q0.x();
+    T const* ay = q0.y();
+    T const* az = q0.z();
+    T const* bw = q1.w();
+    T const* bx = q1.x();
+    T const* by = q1.y();
+    T const* bz = q1.z();
+
+    const std::size_t lanes = soa_lanes<T>::value;
+    std::size_t size = q0.size();
+    std::size_t count = q0.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        // the factors of the padding lanes are not read from t
+        T tb[lanes];
+        if (t)
+        {
+            std::size_t valid = (std::min)(lanes, size - first);
+            std::copy_n(t + first, valid, tb);
+            std::fill(tb + valid, tb + lanes, T(0));
+        }
+        else
+        {
+            std::fill_n(tb, lanes, shared_t);
+        }
+
+        T rw[lanes];
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            T c = aw[k] * bw[k] + ax[k] * bx[k] + ay[k] * by[k] + az[k] * bz[k];
+            T sign = copysign(T(1), c);
+
+            T w0;
+            T w1;
+            weights(tb[l], c * sign, w0, w1);
+            w1 *= sign;
+
+            T w = w0 * aw[k] + w1 * bw[k];
+            T x = w0 * ax[k] + w1 * bx[k];
+            T y = w0 * ay[k] + w1 * by[k];
+            T z = w0 * az[k] + w1 * bz[k];
+
+            // the padding lanes are zero and stay zero
+            T s = w * w + x * x + y * y + z * z;
+            T inv_mag = T(1) / sqrt(s + (s > T(0) ? T(0) : T(1)));
+
+            rw[l] = w * inv_mag;
+            rx[l] = x * inv_mag;
+            ry[l] = y * inv_mag;
+            rz[l] = z * inv_mag;
+        }
+
+        std::copy_n(rw, lanes, out.w() + first);
+        std::copy_n(rx, lanes, out.x() + first);
+        std::copy_n(ry, lanes, out.y() + first);
+        std::copy_n(rz, lanes, out.z() + first);
+    }
+}
+
+template<typename T>
+struct nlerp_weights
+{
+    void operator ()(T t, T, T& w0, T& w1) const
+    {
+        w0 = T(1) - t;
+        w1 = t;
+    }
+};
+
+// sin((1 - t) * angle) / sin(angle) and sin(t * angle) / sin(angle) with fast_acos and fast_sinc,
+// as ratios of sinc the weights have no singularity at angle 0, where they are nlerp's
+template<typename T>
+struct slerp_weights
+{
+    void operator ()(T t, T c, T& w0, T& w1) const
+    {
+        T angle = fast_acos(c);
+        T inv_sinc = T(1) / fast_sinc(angle);
+        T d = T(1) - t;
+
+        w0 = d * fast_sinc(d * angle) * inv_sinc;
+        w1 = t * fast_sinc(t * angle) * inv_sinc;
+    }
+};
+
+// D. Eberly, A Fast and Accurate Algorithm for Computing SLERP.
+// The weights are polynomials in c - 1 whose coefficients only depend on t,
+// so with a shared t the cost per element is two polynomial evaluations.
+// The paper's 8 terms leave an error of 2e-5 near 90 degrees, 16 terms with the
+// correction factor refitted for them leave 3e-8.
+template<typename T>
+struct shared_slerp_weights
+{
+    enum { degree = 16 };
+
+    explicit shared_slerp_weights(T t)
+        : t(t)
+        , d(T(1) - t)
+    {
+        // the last term is scaled by 1 + mu to correct the truncation error
+        const double one_plus_mu = 1.91665;
+        T t2 = t * t;
+        T d2 = d * d;
+        for (int i = 1; i <= degree; ++i)
+        {
+            double scale = i == degree ? one_plus_mu : 1.0;
+            T u = T(scale / (i * (2.0 * i + 1.0)));
+            T v = T(scale * i / (2.0 * i + 1.0));
+            bt[i - 1] = u * t2 - v;
+            bd[i - 1] = u * d2 - v;
+        }
+    }
+
+    void operator ()(T, T c, T& w0, T& w1) const
+    {
+        T xm1 = c - T(1);
+        T f0 = T(1);
+        T f1 = T(1);
+        for (int i = degree; i--;)
+        {
+            f0 = T(1) + bd[i] * xm1 * f0;
+            f1 = T(1) + bt[i] * xm1 * f1;
+        }
+
+        w0 = d * f0;
+        w1 = t * f1;
+    }
+
+    T t;
+    T d;
+    T bt[degree];
+    T bd[degree];
+};
+
+} // namespace detail
+
+// The interpolation functions below take the shortest path, i.e. q1[k] is negated if
+// its dot product with q0[k] is negative, and return unit quaternions.
+
+/// Normalized linear interpolation of q0 and q1 by a shared factor t
+template<typename T>
+void nlerp(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T t, quaternion_stream<T>& out)
+{
+    detail::blend_quaternions(q0, q1, t, static_cast<T const*>(nullptr), out, detail::nlerp_weights<T>());
+}
+
+/// Normalized linear interpolation of q0[k] and q1[k] by t[k], t must have q0.size() elements
+template<typename T>
+void nlerp(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T const* t, quaternion_stream<T>& out)
+{
+    detail::blend_quaternions(q0, q1, T(0), t, out, detail::nlerp_weights<T>());
+}
+
+/// Spherical linear interpolation of q0[k] and q1[k] by t[k], t must have q0.size() elements.
+/// The angle is calculated with fast_acos and the weights as ratios of fast_sinc, the result
+/// differs from slerp by at most 2e-7 per component for float and 1e-8 for double.
+template<typename T>
+void slerp(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T const* t, quaternion_stream<T>& out)
+{
+    detail::blend_quaternions(q0, q1, T(0), t, out, detail::slerp_weights<T>());
+}
+
+/// Spherical linear interpolation of q0 and q1 by a shared factor t.
+/// No trigonometric function is evaluated, the weights are polynomials whose coefficients
+/// are calculated once for t. The result differs from slerp by at most 2e-7 per component
+/// for float and 1e-7 for double.
+template<typename T>
+void slerp(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T t, quaternion_stream<T>& out)
+{
+    KISMET_ASSERT(t >= 0 && t <= 1);
+    detail::blend_quaternions(q0, q1, t, static_cast<T const*>(nullptr), out, detail::shared_slerp_weights<T>(t));
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_QUATERNION_STREAM_H
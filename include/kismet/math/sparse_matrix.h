@@ -0,0 +1,523 @@
+#ifndef KISMET_MATH_SPARSE_MATRIX_H
+#define KISMET_MATH_SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/linear_system.h"
+#include "kismet/math/math_trait.h"
+#include "kismet/math/matrix.h"
+#include "kismet/utility.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A (row, column, value) entry used to build sparse matrices
+template<typename T>
+struct triplet
+{
+    std::size_t row;
+    std::size_t col;
+    T value;
+};
+
+/// A (block row, block column, block) entry used to build block sparse matrices
+template<typename T, std::size_t B>
+struct block_triplet
+{
+    std::size_t row;
+    std::size_t col;
+    matrix<T, B, B> value;
+};
+
+namespace detail
+{
+
+// rows fewer than this are multiplied serially, the threading overhead dominates otherwise
+const std::ptrdiff_t sparse_parallel_rows = 256;
+
+// Build the compressed row structure of a rows x cols matrix from triplets.
+// Columns of each row are sorted, duplicate entries are summed.
+template<typename V, typename ForwardIt>
+void build_compressed_rows(std::size_t rows, std::size_t cols, ForwardIt first, ForwardIt last,
+                           std::vector<std::size_t>& offsets, std::vector<std::size_t>& indices, std::vector<V>& values)
+{
+    using std::size_t;
+    (void)cols;
+
+    // count the entries of each row
+    offsets.assign(rows + 1, 0);
+    for (ForwardIt it = first; it != last; ++it)
+    {
+        KISMET_ASSERT(it->row < rows && it->col < cols);
+        ++offsets[it->row + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    size_t count = offsets[rows];
+    indices.resize(count);
+    values.resize(count);
+
+    // bucket the entries by row
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (ForwardIt it = first; it != last; ++it)
+    {
+        size_t pos = next[it->row]++;
+        indices[pos] = it->col;
+        values[pos] = it->value;
+    }
+
+    // sort each row by column and merge duplicates
+    std::vector<size_t> order;
+    size_t out = 0;
+    for (size_t row = 0; row < rows; ++row)
+    {
+        size_t row_begin = offsets[row];
+        size_t row_end = offsets[row + 1];
+
+        order.resize(row_end - row_begin);
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return indices[row_begin + a] < indices[row_begin + b]; });
+        apply_permutation(order.begin(), order.end(), indices.begin() + row_begin, values.begin() + row_begin);
+
+        offsets[row] = out;
+        for (size_t i = row_begin; i < row_end; ++i)
+        {
+            if (out > offsets[row] && indices[out - 1] == indices[i])
+            {
+                values[out - 1] += values[i];
+            }
+            else
+            {
+                indices[out] = indices[i];
+                values[out] = values[i];
+                ++out;
+            }
+        }
+    }
+    offsets[rows] = out;
+
+    indices.resize(out);
+    values.erase(values.begin() + out, values.end());
+}
+
+} // namespace detail
+
+/// A sparse matrix stored in the compressed sparse row (CSR) format.
+/// The non zero entries of row i are values()[k] for k in [row_offsets()[i], row_offsets()[i + 1]),
+/// column_indices()[k] is the column of the entry, columns are sorted within a row.
+template<typename T>
+class csr_matrix
+{
+public:
+    using size_type  = std::size_t;
+    using value_type = T;
+
+    csr_matrix()
+        : csr_matrix(0, 0)
+    {
+    }
+
+    /// Construct a rows x cols zero matrix
+    csr_matrix(size_type rows, size_type cols)
+        : m_rows(rows)
+        , m_cols(cols)
+        , m_offsets(rows + 1, 0)
+    {
+    }
+
+    /// Construct a rows x cols matrix from a range of triplet<T>, duplicate entries are summed
+    template<typename ForwardIt>
+    csr_matrix(size_type rows, size_type cols, ForwardIt first, ForwardIt last)
+        : m_rows(rows)
+        , m_cols(cols)
+    {
+        detail::build_compressed_rows(rows, cols, first, last, m_offsets, m_indices, m_values);
+    }
+
+    size_type rows() const { return m_rows; }
+    size_type cols() const { return m_cols; }
+
+    // number of stored entries
+    size_type non_zeros() const { return m_values.size(); }
+
+    size_type const* row_offsets() const { return m_offsets.data(); }
+    size_type const* column_indices() const { return m_indices.data(); }
+
+    T*       values()       { return m_values.data(); }
+    T const* values() const { return m_values.data(); }
+
+    /// Return the pointer to the entry at (row, col), nullptr if it is not stored
+    T const* find(size_type row, size_type col) const
+    {
+        KISMET_ASSERT(row < m_rows && col < m_cols);
+        auto first = m_indices.begin() + m_offsets[row];
+        auto last = m_indices.begin() + m_offsets[row + 1];
+        auto it = std::lower_bound(first, last, col);
+        return it != last && *it == col ? &m_values[it - m_indices.begin()] : nullptr;
+    }
+
+    /// Return the element at (row, col)
+    T operator ()(size_type row, size_type col) const
+    {
+        T const* p = find(row, col);
+        return p ? *p : T(0);
+    }
+
+    void swap(csr_matrix& other)
+    {
+        using std::swap;
+        swap(m_rows, other.m_rows);
+        swap(m_cols, other.m_cols);
+        m_offsets.swap(other.m_offsets);
+        m_indices.swap(other.m_indices);
+        m_values.swap(other.m_values);
+    }
+
+private:
+    size_type m_rows;
+    size_type m_cols;
+    std::vector<size_type> m_offsets;
+    std::vector<size_type> m_indices;
+    std::vector<T> m_values;
+};
+
+template<typename T>
+inline void swap(csr_matrix<T>& lhs, csr_matrix<T>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/// A block sparse matrix stored in the block compressed sparse row (BSR) format,
+/// every stored entry is a dense BxB block.
+/// The layout is the same as csr_matrix with rows and columns counted in blocks.
+template<typename T, std::size_t B>
+class bsr_matrix
+{
+public:
+    using size_type  = std::size_t;
+    using value_type = T;
+    using block_type = matrix<T, B, B>;
+
+    enum { block_size = B };
+
+    bsr_matrix()
+        : bsr_matrix(0, 0)
+    {
+    }
+
+    /// Construct a zero matrix of block_rows x block_cols blocks
+    bsr_matrix(size_type block_rows, size_type block_cols)
+        : m_rows(block_rows)
+        , m_cols(block_cols)
+        , m_offsets(block_rows + 1, 0)
+    {
+    }
+
+    /// Construct a matrix of block_rows x block_cols blocks from a range of block_triplet<T, B>,
+    /// duplicate blocks are summed
+    template<typename ForwardIt>
+    bsr_matrix(size_type block_rows, size_type block_cols, ForwardIt first, ForwardIt last)
+        : m_rows(block_rows)
+        , m_cols(block_cols)
+    {
+        detail::build_compressed_rows(block_rows, block_cols, first, last, m_offsets, m_indices, m_blocks);
+    }
+
+    size_type block_rows() const { return m_rows; }
+    size_type block_cols() const { return m_cols; }
+
+    // size in scalars
+    size_type rows() const { return m_rows * B; }
+    size_type cols() const { return m_cols * B; }
+
+    // number of stored blocks
+    size_type non_zero_blocks() const { return m_blocks.size(); }
+
+    size_type const* row_offsets() const { return m_offsets.data(); }
+    size_type const* column_indices() const { return m_indices.data(); }
+
+    block_type*       blocks()       { return m_blocks.data(); }
+    block_type const* blocks() const { return m_blocks.data(); }
+
+    /// Return the pointer to the block at (block_row, block_col), nullptr if it is not stored
+    block_type const* find(size_type block_row, size_type block_col) const
+    {
+        KISMET_ASSERT(block_row < m_rows && block_col < m_cols);
+        auto first = m_indices.begin() + m_offsets[block_row];
+        auto last = m_indices.begin() + m_offsets[block_row + 1];
+        auto it = std::lower_bound(first, last, block_col);
+        return it != last && *it == block_col ? &m_blocks[it - m_indices.begin()] : nullptr;
+    }
+
+    /// Return the scalar element at (row, col)
+    T operator ()(size_type row, size_type col) const
+    {
+        block_type const* p = find(row / B, col / B);
+        return p ? (*p)[row % B][col % B] : T(0);
+    }
+
+    void swap(bsr_matrix& other)
+    {
+        using std::swap;
+        swap(m_rows, other.m_rows);
+        swap(m_cols, other.m_cols);
+        m_offsets.swap(other.m_offsets);
+        m_indices.swap(other.m_indices);
+        m_blocks.swap(other.m_blocks);
+    }
+
+private:
+    size_type m_rows;
+    size_type m_cols;
+    std::vector<size_type> m_offsets;
+    std::vector<size_type> m_indices;
+    std::vector<block_type> m_blocks;
+};
+
+template<typename T, std::size_t B>
+inline void swap(bsr_matrix<T, B>& lhs, bsr_matrix<T, B>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/// Sparse matrix vector multiplication
+///   y = A*x
+/// x has a.cols() elements, y has a.rows() elements and must not overlap x.
+/// Rows are distributed over threads when OpenMP is enabled.
+template<typename T, typename RandIt1, typename RandIt2>
+void multiply(csr_matrix<T> const& a, RandIt1 x, RandIt2 y)
+{
+    std::size_t const* offsets = a.row_offsets();
+    std::size_t const* indices = a.column_indices();
+    T const* values = a.values();
+
+    std::ptrdiff_t rows = static_cast<std::ptrdiff_t>(a.rows());
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if (rows >= detail::sparse_parallel_rows)
+#endif
+    for (std::ptrdiff_t row = 0; row < rows; ++row)
+    {
+        T s(0);
+        for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+        {
+            s += values[k] * x[indices[k]];
+        }
+        y[row] = s;
+    }
+}
+
+/// Block sparse matrix vector multiplication
+///   y = A*x
+/// x has a.cols() elements, y has a.rows() elements and must not overlap x.
+/// Block rows are distributed over threads when OpenMP is enabled.
+template<typename T, std::size_t B, typename RandIt1, typename RandIt2>
+void multiply(bsr_matrix<T, B> const& a, RandIt1 x, RandIt2 y)
+{
+    std::size_t const* offsets = a.row_offsets();
+    std::size_t const* indices = a.column_indices();
+    matrix<T, B, B> const* blocks = a.blocks();
+
+    std::ptrdiff_t rows = static_cast<std::ptrdiff_t>(a.block_rows());
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if (rows * std::ptrdiff_t(B) >= detail::sparse_parallel_rows)
+#endif
+    for (std::ptrdiff_t row = 0; row < rows; ++row)
+    {
+        T s[B] = {};
+        for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+        {
+            T const* block = blocks[k].data();
+            std::size_t col = indices[k] * B;
+            for (std::size_t i = 0; i < B; ++i)
+            {
+                for (std::size_t j = 0; j < B; ++j)
+                {
+                    s[i] += block[i * B + j] * x[col + j];
+                }
+            }
+        }
+
+        std::copy_n(s, B, y + row * B);
+    }
+}
+
+/// Forward substitution
+///   L*x=b
+/// L is a lower triangular sparse matrix, entries above the diagonal are ignored.
+/// x may refer to b.
+/// Return false if a diagonal entry is missing or zero
+template<typename T, typename InputIt, typename RandIt>
+bool forward_substitute(csr_matrix<T> const& l, InputIt b, RandIt x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(l.rows() == l.cols());
+
+    std::size_t const* offsets = l.row_offsets();
+    std::size_t const* indices = l.column_indices();
+    T const* values = l.values();
+
+    for (std::size_t row = 0; row < l.rows(); ++row, ++b)
+    {
+        T v(*b);
+        std::size_t k = offsets[row];
+        for (; k < offsets[row + 1] && indices[k] < row; ++k)
+        {
+            v -= values[k] * x[indices[k]];
+        }
+
+        if (k == offsets[row + 1] || indices[k] != row || is_zero(values[k], tolerance))
+        {
+            return false;
+        }
+
+        x[row] = v * invert(values[k]);
+    }
+
+    return true;
+}
+
+/// Backward substitution
+///   U*x=b
+/// U is an upper triangular sparse matrix, entries below the diagonal are ignored.
+/// x may refer to b.
+/// Return false if a diagonal entry is missing or zero
+template<typename T, typename RandIt1, typename RandIt2>
+bool backward_substitute(csr_matrix<T> const& u, RandIt1 b, RandIt2 x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(u.rows() == u.cols());
+
+    std::size_t const* offsets = u.row_offsets();
+    std::size_t const* indices = u.column_indices();
+    T const* values = u.values();
+
+    for (std::size_t row = u.rows(); row--;)
+    {
+        T v(b[row]);
+        std::size_t k = offsets[row + 1];
+        for (; k > offsets[row] && indices[k - 1] > row; --k)
+        {
+            v -= values[k - 1] * x[indices[k - 1]];
+        }
+
+        if (k == offsets[row] || indices[k - 1] != row || is_zero(values[k - 1], tolerance))
+        {
+            return false;
+        }
+
+        x[row] = v * invert(values[k - 1]);
+    }
+
+    return true;
+}
+
+/// Block forward substitution
+///   L*x=b
+/// L is a block lower triangular sparse matrix, blocks above the diagonal are ignored.
+/// The diagonal blocks are dense and solved with partial pivoting.
+/// x may refer to b.
+/// Return false if a diagonal block is missing or singular
+template<typename T, std::size_t B, typename InputIt, typename RandIt>
+bool forward_substitute(bsr_matrix<T, B> const& l, InputIt b, RandIt x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(l.block_rows() == l.block_cols());
+
+    std::size_t const* offsets = l.row_offsets();
+    std::size_t const* indices = l.column_indices();
+    matrix<T, B, B> const* blocks = l.blocks();
+
+    matrix<T, B, 1> v;
+    matrix<T, B, 1> xi;
+    for (std::size_t row = 0; row < l.block_rows(); ++row)
+    {
+        T* pv = v.data();
+        for (std::size_t i = 0; i < B; ++i, ++b)
+        {
+            pv[i] = *b;
+        }
+
+        std::size_t k = offsets[row];
+        for (; k < offsets[row + 1] && indices[k] < row; ++k)
+        {
+            T const* block = blocks[k].data();
+            std::size_t col = indices[k] * B;
+            for (std::size_t i = 0; i < B; ++i)
+            {
+                for (std::size_t j = 0; j < B; ++j)
+                {
+                    pv[i] -= block[i * B + j] * x[col + j];
+                }
+            }
+        }
+
+        if (k == offsets[row + 1] || indices[k] != row || !solve_partial_pivoting(blocks[k], v, xi, tolerance))
+        {
+            return false;
+        }
+
+        std::copy_n(xi.data(), B, x + row * B);
+    }
+
+    return true;
+}
+
+/// Block backward substitution
+///   U*x=b
+/// U is a block upper triangular sparse matrix, blocks below the diagonal are ignored.
+/// The diagonal blocks are dense and solved with partial pivoting.
+/// x may refer to b.
+/// Return false if a diagonal block is missing or singular
+template<typename T, std::size_t B, typename RandIt1, typename RandIt2>
+bool backward_substitute(bsr_matrix<T, B> const& u, RandIt1 b, RandIt2 x, T tolerance = math_trait<T>::zero_tolerance())
+{
+    KISMET_ASSERT(u.block_rows() == u.block_cols());
+
+    std::size_t const* offsets = u.row_offsets();
+    std::size_t const* indices = u.column_indices();
+    matrix<T, B, B> const* blocks = u.blocks();
+
+    matrix<T, B, 1> v;
+    matrix<T, B, 1> xi;
+    for (std::size_t row = u.block_rows(); row--;)
+    {
+        T* pv = v.data();
+        for (std::size_t i = 0; i < B; ++i)
+        {
+            pv[i] = b[row * B + i];
+        }
+
+        std::size_t k = offsets[row + 1];
+        for (; k > offsets[row] && indices[k - 1] > row; --k)
+        {
+            T const* block = blocks[k - 1].data();
+            std::size_t col = indices[k - 1] * B;
+            for (std::size_t i = 0; i < B; ++i)
+            {
+                for (std::size_t j = 0; j < B; ++j)
+                {
+                    pv[i] -= block[i * B + j] * x[col + j];
+                }
+            }
+        }
+
+        if (k == offsets[row] || indices[k - 1] != row || !solve_partial_pivoting(blocks[k - 1], v, xi, tolerance))
+        {
+            return false;
+        }
+
+        std::copy_n(xi.data(), B, x + row * B);
+    }
+
+    return true;
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_SPARSE_MATRIX_H
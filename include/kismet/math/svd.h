@@ -0,0 +1,343 @@
+#ifndef KISMET_MATH_SVD_H
+#define KISMET_MATH_SVD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "kismet/math/detail/symmetric_eigen.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/matrix_batch.h"
+#include "kismet/math/utility.h"
+#include "kismet/math/vector.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+// Singular value and polar decomposition of 3x3 matrices as McAdams et al., "Computing the
+// Singular Value Decomposition of 3x3 matrices with minimal branching and elementary floating
+// point operations": V are the eigenvectors of A^T*A, the columns of A*V are sorted by length
+// and orthogonalized with Givens rotations, which gives U and the singular values.
+// U and V are rotations, the sign of det(A) is carried by the smallest singular value,
+// so that deformation gradients of inverted elements decompose into a rotation and
+// a stretch with a negative principal value.
+
+namespace detail
+{
+
+// The helpers work on L matrices at once, element (i, j) of the l-th matrix is m[i][j][l].
+// The lane loops are innermost so that they are vectorized, the scalar functions use L = 1.
+
+// Rotate the rows p and q of b to zero b[q][p], and the columns p and q of u by the
+// inverse, so that u*b is unchanged. A zero column gives the identity.
+template<typename T, std::size_t L>
+inline void givens_qr(T (&b)[3][3][L], T (&u)[3][3][L], std::size_t p, std::size_t q)
+{
+    using std::sqrt;
+
+    T c[L];
+    T s[L];
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        T ch = b[p][p][l];
+        T sh = b[q][p][l];
+        T r = sqrt(ch * ch + sh * sh);
+        T k = step((std::numeric_limits<T>::min)(), r);
+        T inv = k / (r + (T(1) - k));
+        c[l] = ch * inv + (T(1) - k);
+        s[l] = sh * inv;
+    }
+
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+        for (std::size_t l = 0; l < L; ++l)
+        {
+            T bp = b[p][j][l];
+            T bq = b[q][j][l];
+            b[p][j][l] = c[l] * bp + s[l] * bq;
+            b[q][j][l] = c[l] * bq - s[l] * bp;
+
+            T up = u[j][p][l];
+            T uq = u[j][q][l];
+            u[j][p][l] = c[l] * up + s[l] * uq;
+            u[j][q][l] = c[l] * uq - s[l] * up;
+        }
+    }
+}
+
+// unique elements of A^T*A as in jacobi_sweep
+template<typename T, std::size_t L>
+inline void normal_matrix(T const (&a)[3][3][L], T (&e)[6][L])
+{
+    const std::size_t index[6][2] = { { 0, 0 }, { 1, 1 }, { 2, 2 }, { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    for (std::size_t k = 0; k < 6; ++k)
+    {
+        std::size_t i = index[k][0];
+        std::size_t j = index[k][1];
+        for (std::size_t l = 0; l < L; ++l)
+        {
+            e[k][l] = a[0][i][l] * a[0][j][l] + a[1][i][l] * a[1][j][l] + a[2][i][l] * a[2][j][l];
+        }
+    }
+}
+
+// The SVD of a given the eigenvectors v of A^T*A in ascending order of the eigenvalues,
+// v is reordered to descending singular values
+template<typename T, std::size_t L>
+inline void svd_from_eigenvectors(T const (&a)[3][3][L], T (&v)[3][3][L], T (&u)[3][3][L], T (&sigma)[3][L])
+{
+    // reversing the columns is a reflection, negating one of them keeps v a rotation
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t l = 0; l < L; ++l)
+        {
+            T v0 = v[i][0][l];
+            v[i][0][l] = v[i][2][l];
+            v[i][1][l] = -v[i][1][l];
+            v[i][2][l] = v0;
+        }
+    }
+
+    T b[3][3][L];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            for (std::size_t l = 0; l < L; ++l)
+            {
+                b[i][j][l] = a[i][0][l] * v[0][j][l] + a[i][1][l] * v[1][j][l] + a[i][2][l] * v[2][j][l];
+            }
+            std::fill_n(u[i][j], L, i == j ? T(1) : T(0));
+        }
+    }
+
+    // the columns of b are orthogonal, so that its QR decomposition has a diagonal R
+    givens_qr(b, u, 0, 1);
+    givens_qr(b, u, 0, 2);
+    givens_qr(b, u, 1, 2);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        std::copy_n(b[i][i], L, sigma[i]);
+    }
+}
+
+// R = U*V^T and S = V*diag(sigma)*V^T
+template<typename T, std::size_t L>
+inline void polar_from_svd(T const (&u)[3][3][L], T const (&sigma)[3][L], T const (&v)[3][3][L],
+                           T (&r)[3][3][L], T (&s)[3][3][L])
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            for (std::size_t l = 0; l < L; ++l)
+            {
+                r[i][j][l] = u[i][0][l] * v[j][0][l] + u[i][1][l] * v[j][1][l] + u[i][2][l] * v[j][2][l];
+                s[i][j][l] = sigma[0][l] * v[i][0][l] * v[j][0][l] + sigma[1][l] * v[i][1][l] * v[j][1][l] +
+                             sigma[2][l] * v[i][2][l] * v[j][2][l];
+            }
+        }
+    }
+}
+
+// the SVD of the matrices of a batch from first to first + L
+template<typename T, std::size_t L>
+inline void svd_lanes(matrix_batch<T, 3, 3> const& a, std::size_t first,
+                      T (&u)[3][3][L], T (&sigma)[3][L], T (&v)[3][3][L])
+{
+    T m[3][3][L];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            std::copy_n(a.element(i, j) + first, L, m[i][j]);
+        }
+    }
+
+    T d[6][L];
+    normal_matrix(m, d);
+    jacobi_eigen(d, v);
+    svd_from_eigenvectors(m, v, u, sigma);
+}
+
+// copy between a matrix and the arrays of a single lane
+template<typename T>
+inline void to_lane(matrix<T, 3, 3> const& m, T (&a)[3][3][1])
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            a[i][j][0] = m[i][j];
+        }
+    }
+}
+
+template<typename T>
+inline void from_lane(T const (&a)[3][3][1], matrix<T, 3, 3>& m)
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            m[i][j] = a[i][j][0];
+        }
+    }
+}
+
+} // namespace detail
+
+/// Singular value decomposition A = U*diag(sigma)*V^T of a 3x3 matrix.
+/// U and V are rotations, sigma[0] >= sigma[1] >= |sigma[2]| and sigma[2] has the sign
+/// of det(A). The singular values are accurate to about epsilon relative to sigma[0],
+/// as V comes from the eigenvectors of A^T*A.
+/// Return false if the eigendecomposition does not converge, e.g. for NaN.
+template<typename T>
+bool svd_decompose(matrix<T, 3, 3> const& a, matrix<T, 3, 3>& u, vector3<T>& sigma, matrix<T, 3, 3>& v)
+{
+    T m[3][3][1];
+    detail::to_lane(a, m);
+
+    // the converging Jacobi method, the closed form is too inaccurate for V
+    T d[6][1];
+    T e[6];
+    T l[3];
+    T vm[3][3];
+    detail::normal_matrix(m, d);
+    std::copy_n(&d[0][0], 6, e);
+    bool ok = detail::eigen_jacobi(e, l, vm, detail::jacobi_max_sweeps);
+
+    T vl[3][3][1];
+    T ul[3][3][1];
+    T sl[3][1];
+    std::copy_n(&vm[0][0], 9, &vl[0][0][0]);
+    detail::svd_from_eigenvectors(m, vl, ul, sl);
+    detail::from_lane(ul, u);
+    detail::from_lane(vl, v);
+    sigma = vector3<T>(sl[0][0], sl[1][0], sl[2][0]);
+    return ok;
+}
+
+/// Polar decomposition A = R*S of a 3x3 matrix from its SVD, R = U*V^T is the rotation
+/// closest to A and S = V*diag(sigma)*V^T is the symmetric stretch. S is positive
+/// semidefinite unless det(A) < 0, in which case R stays a rotation and S has a negative
+/// eigenvalue along the direction of the smallest stretch.
+/// Return false if the SVD fails.
+template<typename T>
+bool polar_decompose(matrix<T, 3, 3> const& a, matrix<T, 3, 3>& r, matrix<T, 3, 3>& s)
+{
+    matrix<T, 3, 3> u;
+    matrix<T, 3, 3> v;
+    vector3<T> sigma;
+    bool ok = svd_decompose(a, u, sigma, v);
+
+    T ul[3][3][1];
+    T vl[3][3][1];
+    T sl[3][1] = { { sigma[0] }, { sigma[1] }, { sigma[2] } };
+    T rl[3][3][1];
+    T pl[3][3][1];
+    detail::to_lane(u, ul);
+    detail::to_lane(v, vl);
+    detail::polar_from_svd(ul, sl, vl, rl, pl);
+    detail::from_lane(rl, r);
+    detail::from_lane(pl, s);
+    return ok;
+}
+
+/// Singular value decomposition of a batch of 3x3 matrices as svd_decompose.
+/// Every lane runs a fixed number of Jacobi sweeps on A^T*A without branches, so that the
+/// compiler maps one matrix to a SIMD lane. batch_kernels has it compiled for the
+/// instruction sets of the CPU.
+template<typename T>
+void svd_decompose(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& u, vector_stream<T, 3>& sigma,
+                   matrix_batch<T, 3, 3>& v)
+{
+    u.resize(a.size());
+    sigma.resize(a.size());
+    v.resize(a.size());
+
+    // blocked as the stream operations
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = a.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T ul[3][3][lanes];
+        T sl[3][lanes];
+        T vl[3][3][lanes];
+        detail::svd_lanes(a, first, ul, sl, vl);
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            std::copy_n(sl[i], lanes, sigma.component(i) + first);
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::copy_n(ul[i][j], lanes, u.element(i, j) + first);
+                std::copy_n(vl[i][j], lanes, v.element(i, j) + first);
+            }
+        }
+    }
+
+    // the zero padding has rotations for U and V
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        detail::clear_padding(sigma.component(i), a.size(), count);
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            detail::clear_padding(u.element(i, j), a.size(), count);
+            detail::clear_padding(v.element(i, j), a.size(), count);
+        }
+    }
+}
+
+/// Polar decomposition of a batch of 3x3 matrices as polar_decompose, e.g. of the
+/// deformation gradients of a corotational solver
+template<typename T>
+void polar_decompose(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& r, matrix_batch<T, 3, 3>& s)
+{
+    r.resize(a.size());
+    s.resize(a.size());
+
+    // blocked as the stream operations
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = a.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T ul[3][3][lanes];
+        T sl[3][lanes];
+        T vl[3][3][lanes];
+        detail::svd_lanes(a, first, ul, sl, vl);
+
+        T rl[3][3][lanes];
+        T pl[3][3][lanes];
+        detail::polar_from_svd(ul, sl, vl, rl, pl);
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::copy_n(rl[i][j], lanes, r.element(i, j) + first);
+                std::copy_n(pl[i][j], lanes, s.element(i, j) + first);
+            }
+        }
+    }
+
+    // the zero padding has a rotation for R
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            detail::clear_padding(r.element(i, j), a.size(), count);
+            detail::clear_padding(s.element(i, j), a.size(), count);
+        }
+    }
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_SVD_H
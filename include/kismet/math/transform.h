@@ -5,6 +5,7 @@
 
 #include "kismet/math/matrix.h"
 #include "kismet/math/quaternion.h"
+#include "kismet/math/svd.h"
 #include "kismet/math/utility.h"
 #include "kismet/math/vector.h"
 
@@ -86,7 +87,7 @@ quaternion<T> matrix_to_quat(matrix44<T> const& m)
         else
         {
             res.z() = std::sqrt(T(1) - m[0][0] - m[1][1] + m[2][2]) * T(0.5);
-            T inv_denom = T(0.25) * res.z();
+            T inv_denom = T(0.25) / res.z();
             res.x() = inv_denom * (m[0][2] + m[2][0]);
             res.y() = inv_denom * (m[1][2] + m[2][1]);
             res.w() = inv_denom * (m[1][0] - m[0][1]);
@@ -143,6 +144,39 @@ inline matrix44<T> euler_yxz_to_matrix(vector3<T> const& e)
     return euler_yxz_to_matrix(e.y(), e.x(), e.z());
 }
 
+// euler angles to quaternion, the same rotation as euler_yxz_to_matrix,
+// i.e. the product of the rotations about y, x and z
+template<typename T>
+quaternion<T> quat_from_euler_yxz(T y, T x, T z)
+{
+    using std::cos;
+    using std::sin;
+
+    T cy = cos(y * T(0.5));
+    T cx = cos(x * T(0.5));
+    T cz = cos(z * T(0.5));
+    T sy = sin(y * T(0.5));
+    T sx = sin(x * T(0.5));
+    T sz = sin(z * T(0.5));
+
+    T cycx = cy * cx;
+    T sysx = sy * sx;
+    T cysx = cy * sx;
+    T sycx = sy * cx;
+
+    return quaternion<T>(
+        cycx * cz + sysx * sz,
+        cysx * cz + sycx * sz,
+        sycx * cz - cysx * sz,
+        cycx * sz - sysx * cz);
+}
+
+template<typename T>
+inline quaternion<T> quat_from_euler_yxz(vector3<T> const& e)
+{
+    return quat_from_euler_yxz(e.y(), e.x(), e.z());
+}
+
 template<typename T>
 inline matrix44<T> matrix_scale(T sx, T sy, T sz)
 {
@@ -185,6 +219,147 @@ inline matrix44<T> matrix_translate(vector3<T> const& delta)
     return matrix_translate(delta.x(), delta.y(), delta.z());
 }
 
+// Affine matrices have the bottom row (0, 0, 0, 1), the functions below only
+// compute the upper 3x4 part and write the constant row directly.
+
+// multiply two affine matrices, cheaper than the general a * b
+template<typename T>
+matrix44<T> multiply_affine(matrix44<T> const& a, matrix44<T> const& b)
+{
+    matrix44<T> res;
+    T const* pa = a.data();
+    T const* pb = b.data();
+    T* pr = res.data();
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        T const* ra = pa + i * 4;
+        T* rr = pr + i * 4;
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            rr[j] = ra[0] * pb[j] + ra[1] * pb[4 + j] + ra[2] * pb[8 + j];
+        }
+        rr[3] += ra[3];
+    }
+
+    pr[12] = pr[13] = pr[14] = T(0);
+    pr[15] = T(1);
+    return res;
+}
+
+namespace detail
+{
+
+// Fill the inverse of an affine matrix whose 3x3 part inverse is already in res,
+// the translation becomes -L^-1 * t
+template<typename T>
+inline void finish_affine_inverse(matrix44<T> const& m, matrix44<T>& res)
+{
+    T const* pm = m.data();
+    T* pr = res.data();
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        T* r = pr + i * 4;
+        r[3] = -(r[0] * pm[3] + r[1] * pm[7] + r[2] * pm[11]);
+    }
+
+    pr[12] = pr[13] = pr[14] = T(0);
+    pr[15] = T(1);
+}
+
+} // namespace detail
+
+// invert an affine matrix, the 3x3 part is inverted with its adjugate
+// res may refer to m, it is not changed if the function fails
+// return false if the matrix is not invertible
+template<typename T>
+bool invert_affine(matrix44<T> const& m, matrix44<T>& res, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix44<T> inv;
+    T const* a = m.data();
+    T* r = inv.data();
+
+    r[0] = a[5] * a[10] - a[6] * a[9];
+    r[1] = a[2] * a[9] - a[1] * a[10];
+    r[2] = a[1] * a[6] - a[2] * a[5];
+    r[4] = a[6] * a[8] - a[4] * a[10];
+    r[5] = a[0] * a[10] - a[2] * a[8];
+    r[6] = a[2] * a[4] - a[0] * a[6];
+    r[8] = a[4] * a[9] - a[5] * a[8];
+    r[9] = a[1] * a[8] - a[0] * a[9];
+    r[10] = a[0] * a[5] - a[1] * a[4];
+
+    T det = a[0] * r[0] + a[1] * r[4] + a[2] * r[8];
+    if (is_zero(det, tolerance))
+    {
+        return false;
+    }
+
+    T inv_det = invert(det);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        r[i * 4] *= inv_det;
+        r[i * 4 + 1] *= inv_det;
+        r[i * 4 + 2] *= inv_det;
+    }
+
+    detail::finish_affine_inverse(m, inv);
+    res = inv;
+    return true;
+}
+
+// invert an affine matrix, if the matrix is not invertible, original matrix is returned
+template<typename T>
+inline matrix44<T> invert_affine(matrix44<T> const& m, T tolerance = math_trait<T>::zero_tolerance())
+{
+    matrix44<T> res;
+    return invert_affine(m, res, tolerance) ? res : m;
+}
+
+// invert a rigid transform, i.e. rotation and translation only,
+// the inverse rotation is the transpose
+template<typename T>
+matrix44<T> invert_rigid(matrix44<T> const& m)
+{
+    matrix44<T> res;
+    T const* a = m.data();
+    T* r = res.data();
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            r[i * 4 + j] = a[j * 4 + i];
+        }
+    }
+
+    detail::finish_affine_inverse(m, res);
+    return res;
+}
+
+// invert a TRS matrix with non zero scale.
+// The 3x3 part is R*S, whose inverse S^-1*R^T has the i-th row equal to
+// the i-th column divided by its squared length, no square root is needed.
+template<typename T>
+matrix44<T> invert_trs(matrix44<T> const& m)
+{
+    matrix44<T> res;
+    T const* a = m.data();
+    T* r = res.data();
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        T inv_s2 = invert(a[i] * a[i] + a[4 + i] * a[4 + i] + a[8 + i] * a[8 + i]);
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            r[i * 4 + j] = a[j * 4 + i] * inv_s2;
+        }
+    }
+
+    detail::finish_affine_inverse(m, res);
+    return res;
+}
+
 // extract scale from the TRS matrix
 template<typename T>
 inline vector3<T> extract_scale(matrix44<T> const& m)
@@ -216,19 +391,187 @@ inline quaternion<T> extract_quaternion(matrix44<T> const& m)
     return matrix_to_quat(tmp);
 }
 
-// extract scale and rotation from the TRS matrix
+// Extract scale and rotation from the upper left 3x3 of the matrix by polar decomposition.
+// It is exact for a TRS matrix, with shear the rotation is the closest one and the scale
+// is the diagonal of the stretch. A reflection results in a negative scale.
 template<typename T>
-inline void extract_sr(matrix44<T> const& m, vector3<T>& s, quaternion<T>& q)
+void extract_sr(matrix44<T> const& m, vector3<T>& s, quaternion<T>& q)
 {
-    extract_scale(m, s);
-    matrix44<T> tmp(m);
+    matrix<T, 3, 3> a;
     for (std::size_t i = 0; i < 3; ++i)
     {
-        tmp.column(i) /= s[i];
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            a[i][j] = m[i][j];
+        }
+    }
+
+    matrix<T, 3, 3> r;
+    matrix<T, 3, 3> stretch;
+    polar_decompose(a, r, stretch);
+    s = vector3<T>(stretch[0][0], stretch[1][1], stretch[2][2]);
+
+    matrix44<T> tmp(matrix44<T>::identity);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            tmp[i][j] = r[i][j];
+        }
+    }
+    q = matrix_to_quat(tmp);
+}
+
+/// A transform stored as translation, rotation and scale, applied to a point as
+/// translation + rotation * (scale * p), i.e. the matrix T * R * S.
+/// matrix() calculates the matrix on demand and doesn't write to the object, so concurrent
+/// reads are safe. cached_matrix() keeps it until a component changes.
+/// As TRS can't represent a shear, compose and invert are exact if the scale is uniform,
+/// otherwise the scale is combined per axis as most scene graphs do.
+template<typename T>
+class transform
+{
+public:
+    // the identity transform
+    transform()
+        : m_translation(T(0), T(0), T(0))
+        , m_rotation(quaternion<T>::identity)
+        , m_scale(T(1), T(1), T(1))
+    {
+    }
+
+    transform(vector3<T> const& translation, quaternion<T> const& rotation,
+              vector3<T> const& scale = vector3<T>(T(1), T(1), T(1)))
+        : m_translation(translation)
+        , m_rotation(rotation)
+        , m_scale(scale)
+    {
+    }
+
+    vector3<T> const& translation() const { return m_translation; }
+    quaternion<T> const& rotation() const { return m_rotation; }
+    vector3<T> const& scale() const { return m_scale; }
+
+    void set_translation(vector3<T> const& translation)
+    {
+        m_translation = translation;
+        m_dirty = true;
+    }
+
+    // rotation must be a unit quaternion
+    void set_rotation(quaternion<T> const& rotation)
+    {
+        m_rotation = rotation;
+        m_dirty = true;
+    }
+
+    void set_scale(vector3<T> const& scale)
+    {
+        m_scale = scale;
+        m_dirty = true;
+    }
+
+    // return the matrix T * R * S
+    matrix44<T> matrix() const
+    {
+        return m_dirty ? make_matrix() : m_matrix;
+    }
+
+    // return the matrix T * R * S, calculated on the first call after a change
+    matrix44<T> const& cached_matrix()
+    {
+        if (m_dirty)
+        {
+            m_matrix = make_matrix();
+            m_dirty = false;
+        }
+        return m_matrix;
+    }
+
+    // transform a point
+    vector3<T> transform_point(vector3<T> const& p) const
+    {
+        return m_translation + m_rotation * (m_scale * p);
+    }
+
+    // transform a direction, the translation is ignored
+    vector3<T> transform_vector(vector3<T> const& v) const
+    {
+        return m_rotation * (m_scale * v);
+    }
+
+    // right multiply a transform, i.e. *this = *this * rhs, which applies rhs first
+    transform& operator *=(transform const& rhs)
+    {
+        m_translation = transform_point(rhs.m_translation);
+        m_rotation *= rhs.m_rotation;
+        m_scale *= rhs.m_scale;
+        m_dirty = true;
+        return *this;
+    }
+
+    // invert the transform
+    // return false if a scale is zero
+    bool invert(T tolerance = math_trait<T>::zero_tolerance())
+    {
+        if (is_zero(m_scale.x(), tolerance) || is_zero(m_scale.y(), tolerance) || is_zero(m_scale.z(), tolerance))
+        {
+            return false;
+        }
+
+        m_rotation = conjugate(m_rotation);
+        m_scale = vector3<T>(math::invert(m_scale.x()), math::invert(m_scale.y()), math::invert(m_scale.z()));
+        m_translation = -(m_scale * (m_rotation * m_translation));
+        m_dirty = true;
+        return true;
+    }
+private:
+    matrix44<T> make_matrix() const
+    {
+        matrix44<T> m = matrix_rotate(m_rotation);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            m[i][0] *= m_scale.x();
+            m[i][1] *= m_scale.y();
+            m[i][2] *= m_scale.z();
+            m[i][3] = m_translation[i];
+        }
+        return m;
     }
-    extract_quaternion(tmp, q);
+
+    vector3<T> m_translation;
+    quaternion<T> m_rotation;
+    vector3<T> m_scale;
+
+    matrix44<T> m_matrix;
+    bool m_dirty = true;
+};
+
+template<typename T>
+inline transform<T> operator *(transform<T> lhs, transform<T> const& rhs)
+{
+    return lhs *= rhs;
 }
 
+// return the inverse of the transform, if a scale is zero, the original transform is returned
+template<typename T>
+inline transform<T> invert(transform<T> const& t, T tolerance = math_trait<T>::zero_tolerance())
+{
+    transform<T> res(t);
+    res.invert(tolerance);
+    return res;
+}
+
+template<typename T>
+inline bool invert(transform<T> const& t, transform<T>& res, T tolerance = math_trait<T>::zero_tolerance())
+{
+    res = t;
+    return res.invert(tolerance);
+}
+
+using transformf = transform<float>;
+using transformd = transform<double>;
+
 } // namespace math
 } // namespace kismet
 
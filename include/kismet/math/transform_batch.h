@@ -0,0 +1,327 @@
+#ifndef KISMET_MATH_TRANSFORM_BATCH_H
+#define KISMET_MATH_TRANSFORM_BATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/matrix_batch.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/utility.h"
+#include "kismet/math/vector_stream.h"
+
+namespace kismet
+{
+namespace math
+{
+
+// Batch versions of the conversions in transform.h. They have no branches, so that the
+// compiler maps one conversion to a SIMD lane, and use the polynomial sin and cos of
+// utility.h instead of the library calls. Like the stream operations, the outputs are
+// resized and whole lanes are converted, the padding of the outputs is cleared afterwards.
+
+namespace detail
+{
+
+// sin and cos of half the angle x, x is reduced to [-pi, pi] first.
+// The reduction changes the sign of both, which flips a quaternion to the same rotation.
+template<typename T>
+inline void half_angle_sincos(T x, T& s, T& c)
+{
+    using std::rint;
+
+    const T two_pi = T(6.28318530717958647692);
+    const T inv_two_pi = T(0.15915494309189533577);
+    T r = x - two_pi * rint(x * inv_two_pi);
+    fast_sincos(r * T(0.5), s, c);
+}
+
+// write the elements of a 4x4 matrix which are not part of the rotation
+template<typename T, std::size_t N>
+inline void fill_affine_elements(matrix_batch<T, N, N>& out, std::size_t count)
+{
+    static_assert(N == 3 || N == 4, "N must be 3 or 4");
+    if (N == 4)
+    {
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            std::fill_n(out.element(i, N - 1), count, T(0));
+            std::fill_n(out.element(N - 1, i), count, T(0));
+        }
+        std::fill_n(out.element(N - 1, N - 1), count, T(1));
+    }
+}
+
+// zero the padding of the rotation elements, the others are only written up to size()
+template<typename T, std::size_t N>
+inline void clear_rotation_padding(matrix_batch<T, N, N>& out)
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            clear_padding(out.element(i, j), out.size(), out.stride());
+        }
+    }
+}
+
+template<typename T>
+inline void clear_padding(quaternion_stream<T>& q)
+{
+    clear_padding(q.w(), q.size(), q.stride());
+    clear_padding(q.x(), q.size(), q.stride());
+    clear_padding(q.y(), q.size(), q.stride());
+    clear_padding(q.z(), q.size(), q.stride());
+}
+
+} // namespace detail
+
+/// Convert the euler angles of e to quaternions, the rotation is the same as quat_from_euler_yxz(e[k])
+/// up to the sign of the quaternion
+template<typename T>
+void quat_from_euler_yxz(vector_stream<T, 3> const& e, quaternion_stream<T>& out)
+{
+    out.resize(e.size());
+
+    T const* ex = e.component(0);
+    T const* ey = e.component(1);
+    T const* ez = e.component(2);
+
+    // blocked as the stream operations
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = e.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T rw[lanes];
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            T sx, cx, sy, cy, sz, cz;
+            detail::half_angle_sincos(ex[k], sx, cx);
+            detail::half_angle_sincos(ey[k], sy, cy);
+            detail::half_angle_sincos(ez[k], sz, cz);
+
+            T cycx = cy * cx;
+            T sysx = sy * sx;
+            T cysx = cy * sx;
+            T sycx = sy * cx;
+
+            rw[l] = cycx * cz + sysx * sz;
+            rx[l] = cysx * cz + sycx * sz;
+            ry[l] = sycx * cz - cysx * sz;
+            rz[l] = cycx * sz - sysx * cz;
+        }
+
+        std::copy_n(rw, lanes, out.w() + first);
+        std::copy_n(rx, lanes, out.x() + first);
+        std::copy_n(ry, lanes, out.y() + first);
+        std::copy_n(rz, lanes, out.z() + first);
+    }
+
+    // zero angles are the identity rotation
+    detail::clear_padding(out);
+}
+
+/// Convert the euler angles of e to rotation matrices as euler_yxz_to_matrix,
+/// out is a batch of 3x3 rotations or 4x4 affine matrices
+template<typename T, std::size_t N>
+void euler_yxz_to_matrix(vector_stream<T, 3> const& e, matrix_batch<T, N, N>& out)
+{
+    out.resize(e.size());
+
+    T const* ex = e.component(0);
+    T const* ey = e.component(1);
+    T const* ez = e.component(2);
+    T* m[3][3];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            m[i][j] = out.element(i, j);
+        }
+    }
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = e.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T r[3][3][lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            // sin(a) = 2 sin(a/2) cos(a/2), cos(a) = cos(a/2)^2 - sin(a/2)^2
+            T hsx, hcx, hsy, hcy, hsz, hcz;
+            detail::half_angle_sincos(ex[k], hsx, hcx);
+            detail::half_angle_sincos(ey[k], hsy, hcy);
+            detail::half_angle_sincos(ez[k], hsz, hcz);
+            T sx = T(2) * hsx * hcx;
+            T cx = hcx * hcx - hsx * hsx;
+            T sy = T(2) * hsy * hcy;
+            T cy = hcy * hcy - hsy * hsy;
+            T sz = T(2) * hsz * hcz;
+            T cz = hcz * hcz - hsz * hsz;
+
+            T sysx = sy * sx;
+            T cysx = cy * sx;
+
+            r[0][0][l] = cy * cz + sysx * sz;
+            r[0][1][l] = -cy * sz + sysx * cz;
+            r[0][2][l] = sy * cx;
+            r[1][0][l] = cx * sz;
+            r[1][1][l] = cx * cz;
+            r[1][2][l] = -sx;
+            r[2][0][l] = -sy * cz + cysx * sz;
+            r[2][1][l] = sy * sz + cysx * cz;
+            r[2][2][l] = cy * cx;
+        }
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::copy_n(r[i][j], lanes, m[i][j] + first);
+            }
+        }
+    }
+
+    detail::clear_rotation_padding(out);
+    detail::fill_affine_elements(out, out.size());
+}
+
+/// Convert the unit quaternions of q to rotation matrices as matrix_rotate,
+/// out is a batch of 3x3 rotations or 4x4 affine matrices
+template<typename T, std::size_t N>
+void matrix_rotate(quaternion_stream<T> const& q, matrix_batch<T, N, N>& out)
+{
+    out.resize(q.size());
+
+    T const* qw = q.w();
+    T const* qx = q.x();
+    T const* qy = q.y();
+    T const* qz = q.z();
+    T* m[3][3];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            m[i][j] = out.element(i, j);
+        }
+    }
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = q.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T r[3][3][lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            T w2 = qw[k] * qw[k];
+            T xy = qx[k] * qy[k];
+            T wz = qw[k] * qz[k];
+            T xz = qx[k] * qz[k];
+            T wy = qw[k] * qy[k];
+            T yz = qy[k] * qz[k];
+            T wx = qw[k] * qx[k];
+
+            r[0][0][l] = T(2) * (w2 + qx[k] * qx[k]) - T(1);
+            r[0][1][l] = T(2) * (xy - wz);
+            r[0][2][l] = T(2) * (xz + wy);
+            r[1][0][l] = T(2) * (xy + wz);
+            r[1][1][l] = T(2) * (w2 + qy[k] * qy[k]) - T(1);
+            r[1][2][l] = T(2) * (yz - wx);
+            r[2][0][l] = T(2) * (xz - wy);
+            r[2][1][l] = T(2) * (yz + wx);
+            r[2][2][l] = T(2) * (w2 + qz[k] * qz[k]) - T(1);
+        }
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::copy_n(r[i][j], lanes, m[i][j] + first);
+            }
+        }
+    }
+
+    detail::clear_rotation_padding(out);
+    detail::fill_affine_elements(out, out.size());
+}
+
+/// Convert the rotation matrices of m to unit quaternions as matrix_to_quat.
+/// Instead of branching on the largest diagonal element, the candidates are blended with
+/// a one-hot mask of the largest of 4w^2, 4x^2, 4y^2 and 4z^2, which is also the most accurate
+/// choice. The result may differ from matrix_to_quat in the sign of the quaternion.
+template<typename T, std::size_t N>
+void matrix_to_quat(matrix_batch<T, N, N> const& m, quaternion_stream<T>& out)
+{
+    static_assert(N == 3 || N == 4, "N must be 3 or 4");
+    using std::sqrt;
+
+    out.resize(m.size());
+
+    T const* m00 = m.element(0, 0);
+    T const* m01 = m.element(0, 1);
+    T const* m02 = m.element(0, 2);
+    T const* m10 = m.element(1, 0);
+    T const* m11 = m.element(1, 1);
+    T const* m12 = m.element(1, 2);
+    T const* m20 = m.element(2, 0);
+    T const* m21 = m.element(2, 1);
+    T const* m22 = m.element(2, 2);
+
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = m.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T rw[lanes];
+        T rx[lanes];
+        T ry[lanes];
+        T rz[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            // 4 times the squared components
+            T sw = T(1) + m00[k] + m11[k] + m22[k];
+            T sx = T(1) + m00[k] - m11[k] - m22[k];
+            T sy = T(1) - m00[k] + m11[k] - m22[k];
+            T sz = T(1) - m00[k] - m11[k] + m22[k];
+
+            // 4 times the products of two components
+            T wx = m21[k] - m12[k];
+            T wy = m02[k] - m20[k];
+            T wz = m10[k] - m01[k];
+            T xy = m01[k] + m10[k];
+            T xz = m02[k] + m20[k];
+            T yz = m12[k] + m21[k];
+
+            // one-hot mask of the largest, the first one wins ties
+            T kw = step(sx, sw) * step(sy, sw) * step(sz, sw);
+            T kx = (T(1) - kw) * step(sy, sx) * step(sz, sx);
+            T ky = (T(1) - kw - kx) * step(sz, sy);
+            T kz = T(1) - kw - kx - ky;
+
+            // with the pivot component p, every component c is 4pc / (4p)
+            T smax = kw * sw + kx * sx + ky * sy + kz * sz;
+            T inv = T(0.5) / sqrt(smax);
+
+            rw[l] = (kw * sw + kx * wx + ky * wy + kz * wz) * inv;
+            rx[l] = (kw * wx + kx * sx + ky * xy + kz * xz) * inv;
+            ry[l] = (kw * wy + kx * xy + ky * sy + kz * yz) * inv;
+            rz[l] = (kw * wz + kx * xz + ky * yz + kz * sz) * inv;
+        }
+
+        std::copy_n(rw, lanes, out.w() + first);
+        std::copy_n(rx, lanes, out.x() + first);
+        std::copy_n(ry, lanes, out.y() + first);
+        std::copy_n(rz, lanes, out.z() + first);
+    }
+
+    // zero matrices don't convert to zero quaternions
+    detail::clear_padding(out);
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_TRANSFORM_BATCH_H
@@ -0,0 +1,207 @@
+#ifndef KISMET_MATH_TRANSFORM_HIERARCHY_H
+#define KISMET_MATH_TRANSFORM_HIERARCHY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/transform.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A hierarchy of affine transforms whose nodes are stored in topological order,
+/// i.e. the parent of a node always has a smaller index. The parents, local and world
+/// matrices are separate arrays, so that update() computes all world matrices in one
+/// linear pass where the parent's world matrix is already up to date.
+/// Only the nodes whose local matrix changed and their descendants are recomputed.
+template<typename T>
+class transform_hierarchy
+{
+public:
+    using size_type = std::size_t;
+
+    // the parent of a root node
+    static const size_type no_parent = (std::numeric_limits<size_type>::max)();
+
+    size_type size() const { return m_parents.size(); }
+
+    bool empty() const { return m_parents.empty(); }
+
+    void reserve(size_type n)
+    {
+        m_parents.reserve(n);
+        m_local.reserve(n);
+        m_world.reserve(n);
+        m_dirty.reserve(n);
+        m_changed.reserve(n);
+    }
+
+    // Add a node with an affine local matrix and return its index,
+    // the parent must already exist or be no_parent
+    size_type add(size_type parent, matrix44<T> const& local)
+    {
+        KISMET_ASSERT(parent == no_parent || parent < size());
+
+        m_parents.push_back(parent);
+        m_local.push_back(local);
+        m_world.push_back(local);
+        m_dirty.push_back(1);
+        m_changed.push_back(1);
+        m_groups_valid = false;
+        return size() - 1;
+    }
+
+    size_type add(size_type parent, transform<T> const& local)
+    {
+        return add(parent, local.matrix());
+    }
+
+    size_type parent(size_type i) const
+    {
+        KISMET_ASSERT(i < size());
+        return m_parents[i];
+    }
+
+    matrix44<T> const& local(size_type i) const
+    {
+        KISMET_ASSERT(i < size());
+        return m_local[i];
+    }
+
+    // return the world matrix as of the last update
+    matrix44<T> const& world(size_type i) const
+    {
+        KISMET_ASSERT(i < size());
+        return m_world[i];
+    }
+
+    // return whether the world matrix changed in the last update
+    bool world_changed(size_type i) const
+    {
+        KISMET_ASSERT(i < size());
+        return m_changed[i] != 0;
+    }
+
+    // Replace the local matrix, the world matrices of the node and its descendants
+    // are recomputed in the next update
+    void set_local(size_type i, matrix44<T> const& local)
+    {
+        KISMET_ASSERT(i < size());
+        m_local[i] = local;
+        m_dirty[i] = 1;
+    }
+
+    void set_local(size_type i, transform<T> const& local)
+    {
+        set_local(i, local.matrix());
+    }
+
+    // Recompute the world matrices of the changed nodes.
+    // In parallel mode the subtrees of different roots are updated by different threads,
+    // if OpenMP is not enabled, parallel is ignored.
+    void update(bool parallel = false)
+    {
+#ifdef _OPENMP
+        if (parallel)
+        {
+            update_groups();
+            std::ptrdiff_t groups = static_cast<std::ptrdiff_t>(m_group_offsets.size()) - 1;
+            #pragma omp parallel for schedule(dynamic)
+            for (std::ptrdiff_t g = 0; g < groups; ++g)
+            {
+                for (size_type k = m_group_offsets[g]; k < m_group_offsets[g + 1]; ++k)
+                {
+                    update_node(m_group_nodes[k]);
+                }
+            }
+            return;
+        }
+#else
+        (void)parallel;
+#endif
+        size_type n = size();
+        for (size_type i = 0; i < n; ++i)
+        {
+            update_node(i);
+        }
+    }
+private:
+    // The parent is updated before, so its changed flag is final. The dirty flag is
+    // cleared here, the changed flag is kept until the next update.
+    void update_node(size_type i)
+    {
+        size_type p = m_parents[i];
+        std::uint8_t changed = m_dirty[i] | (p == no_parent ? std::uint8_t(0) : m_changed[p]);
+        if (changed)
+        {
+            m_world[i] = p == no_parent ? m_local[i] : multiply_affine(m_world[p], m_local[i]);
+        }
+        m_changed[i] = changed;
+        m_dirty[i] = 0;
+    }
+
+    // Group the nodes by their root, the nodes of a group stay in topological order.
+    // Only rebuilt after nodes are added.
+    void update_groups()
+    {
+        if (m_groups_valid)
+        {
+            return;
+        }
+
+        size_type n = size();
+        std::vector<size_type> group(n);
+        size_type groups = 0;
+        for (size_type i = 0; i < n; ++i)
+        {
+            size_type p = m_parents[i];
+            group[i] = p == no_parent ? groups++ : group[p];
+        }
+
+        // counting sort by group
+        m_group_offsets.assign(groups + 1, 0);
+        for (size_type i = 0; i < n; ++i)
+        {
+            ++m_group_offsets[group[i] + 1];
+        }
+        for (size_type g = 0; g < groups; ++g)
+        {
+            m_group_offsets[g + 1] += m_group_offsets[g];
+        }
+
+        m_group_nodes.resize(n);
+        std::vector<size_type> next(m_group_offsets.begin(), m_group_offsets.end() - 1);
+        for (size_type i = 0; i < n; ++i)
+        {
+            m_group_nodes[next[group[i]]++] = i;
+        }
+        m_groups_valid = true;
+    }
+
+    std::vector<size_type> m_parents;
+    std::vector<matrix44<T>> m_local;
+    std::vector<matrix44<T>> m_world;
+    // the local matrix changed since the last update
+    std::vector<std::uint8_t> m_dirty;
+    // the world matrix changed in the last update
+    std::vector<std::uint8_t> m_changed;
+
+    std::vector<size_type> m_group_offsets;
+    std::vector<size_type> m_group_nodes;
+    bool m_groups_valid = false;
+};
+
+template<typename T>
+const typename transform_hierarchy<T>::size_type transform_hierarchy<T>::no_parent;
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_TRANSFORM_HIERARCHY_H
@@ -1,6 +1,8 @@
 #ifndef KISMET_MATH_UTILITY_H
 #define KISMET_MATH_UTILITY_H
 
+#include <cmath>
+
 #include "kismet/math/math_trait.h"
 #include "kismet/core/assert.h"
 
@@ -65,6 +67,80 @@ int max_index(T a, T b, T c)
     }
 }
 
+// Return 0 if x < edge, otherwise 1, as GLSL step.
+// The result is built from the sign bit of x - edge instead of a comparison,
+// which compilers don't turn into a SIMD mask unless FP traps are disabled.
+template<typename T>
+inline T step(T edge, T x)
+{
+    using std::copysign;
+    return T(0.5) + T(0.5) * copysign(T(1), x - edge);
+}
+
+// Polynomial approximation of acos for x in [-1, 1] which has no branches,
+// Abramowitz and Stegun 4.4.46. The maximum absolute error is 3e-8 for double,
+// 5e-7 for float which is dominated by rounding.
+template<typename T>
+inline T fast_acos(T x)
+{
+    using std::abs;
+    using std::copysign;
+    using std::sqrt;
+
+    T ax = abs(x);
+    T p = T(-0.0012624911);
+    p = p * ax + T(0.0066700901);
+    p = p * ax - T(0.0170881256);
+    p = p * ax + T(0.0308918810);
+    p = p * ax - T(0.0501743046);
+    p = p * ax + T(0.0889789874);
+    p = p * ax - T(0.2145988016);
+    p = p * ax + T(1.5707963050);
+
+    // acos(-x) = pi - acos(x), selected by the sign bit
+    const T half_pi = T(1.57079632679489661923);
+    T r = sqrt(T(1) - ax) * p;
+    return half_pi + copysign(T(1), x) * (r - half_pi);
+}
+
+// Polynomial approximation of sin(x) / x for x in [-pi/2, pi/2] which has no branches
+// and is well defined at 0, the Taylor series up to x^10.
+template<typename T>
+inline T fast_sinc(T x)
+{
+    T x2 = x * x;
+    T p = T(-1.0 / 39916800.0);
+    p = p * x2 + T(1.0 / 362880.0);
+    p = p * x2 - T(1.0 / 5040.0);
+    p = p * x2 + T(1.0 / 120.0);
+    p = p * x2 - T(1.0 / 6.0);
+    return p * x2 + T(1);
+}
+
+// Polynomial approximation of sin for x in [-pi/2, pi/2] which has no branches.
+// The maximum absolute error is 6e-8 for double, 2e-7 for float which is dominated by rounding.
+template<typename T>
+inline T fast_sin(T x)
+{
+    return fast_sinc(x) * x;
+}
+
+// Polynomial approximation of sin and cos for x in [-pi/2, pi/2] which has no branches,
+// cos is the Taylor series up to x^12, its maximum absolute error is 1e-8 for double.
+template<typename T>
+inline void fast_sincos(T x, T& s, T& c)
+{
+    T x2 = x * x;
+    T p = T(1.0 / 479001600.0);
+    p = p * x2 - T(1.0 / 3628800.0);
+    p = p * x2 + T(1.0 / 40320.0);
+    p = p * x2 - T(1.0 / 720.0);
+    p = p * x2 + T(1.0 / 24.0);
+    p = p * x2 - T(0.5);
+    c = p * x2 + T(1);
+    s = fast_sin(x);
+}
+
 } // namespace math
 
 } // namespace kismet
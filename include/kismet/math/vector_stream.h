@@ -0,0 +1,345 @@
+#ifndef KISMET_MATH_VECTOR_STREAM_H
+#define KISMET_MATH_VECTOR_STREAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+
+#include "kismet/core/assert.h"
+#include "kismet/math/detail/soa_storage.h"
+#include "kismet/math/math_trait.h"
+#include "kismet/math/vector.h"
+
+namespace kismet
+{
+namespace math
+{
+
+/// A stream of N-d vectors stored as a structure of arrays.
+/// Component c of all vectors is contiguous, component c of the k-th vector
+/// is component(c)[k], so bulk operations work on one vector per SIMD lane.
+/// Every component array is padded with zeros to stride() elements, bulk operations
+/// between streams process the padding too, which saves the scalar remainder loop.
+template<typename T, std::size_t N>
+class vector_stream
+{
+    static_assert(N > 0, "N must be positive");
+public:
+    using size_type   = std::size_t;
+    using value_type  = T;
+    using pointer     = T*;
+    using const_pointer = T const*;
+    using vector_type = vector<T, N>;
+
+    vector_stream() = default;
+
+    explicit vector_stream(size_type n)
+        : m_storage(n)
+    {
+    }
+
+    /// Construct from a range of vector<T, N>
+    template<typename InputIt>
+    vector_stream(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    // Return the number of vectors
+    size_type size() const { return m_storage.size(); }
+
+    bool empty() const { return size() == 0; }
+
+    // Resize the stream, existing vectors are preserved, new vectors are zero
+    void resize(size_type n) { m_storage.resize(n); }
+
+    // Return the size of the component arrays including the zero padding
+    size_type stride() const { return m_storage.stride(); }
+
+    // Return the array of component c of all vectors
+    pointer component(size_type c) { return m_storage.component(c); }
+    const_pointer component(size_type c) const { return m_storage.component(c); }
+
+    // Replace the content with a range of vector<T, N>
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        resize(static_cast<size_type>(std::distance(first, last)));
+        for (size_type k = 0; first != last; ++first, ++k)
+        {
+            set(k, *first);
+        }
+    }
+
+    // Copy all vectors to out as vector<T, N>
+    template<typename OutputIt>
+    OutputIt copy_to(OutputIt out) const
+    {
+        for (size_type k = 0; k < size(); ++k, ++out)
+        {
+            *out = get(k);
+        }
+        return out;
+    }
+
+    // Return the k-th vector
+    vector_type get(size_type k) const
+    {
+        KISMET_ASSERT(k < size());
+        vector_type v;
+        for (size_type c = 0; c < N; ++c)
+        {
+            v[c] = m_storage.component(c)[k];
+        }
+        return v;
+    }
+
+    // Replace the k-th vector
+    void set(size_type k, vector_type const& v)
+    {
+        KISMET_ASSERT(k < size());
+        for (size_type c = 0; c < N; ++c)
+        {
+            m_storage.component(c)[k] = v[c];
+        }
+    }
+
+    void swap(vector_stream& rhs)
+    {
+        m_storage.swap(rhs.m_storage);
+    }
+private:
+    detail::soa_storage<T, N> m_storage;
+};
+
+template<typename T, std::size_t N>
+inline void swap(vector_stream<T, N>& lhs, vector_stream<T, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+// The bulk operations below resize the output stream to the size of the inputs,
+// the output may refer to one of the inputs.
+
+/// Calculate the dot products of a and b, out must have room for a.size() elements
+template<typename T, std::size_t N>
+void dot(vector_stream<T, N> const& a, vector_stream<T, N> const& b, T* out)
+{
+    KISMET_ASSERT(a.size() == b.size());
+
+    T const* pa[N];
+    T const* pb[N];
+    for (std::size_t c = 0; c < N; ++c)
+    {
+        pa[c] = a.component(c);
+        pb[c] = b.component(c);
+    }
+
+    std::size_t count = a.size();
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        T s = pa[0][k] * pb[0][k];
+        for (std::size_t c = 1; c < N; ++c)
+        {
+            s += pa[c][k] * pb[c][k];
+        }
+        out[k] = s;
+    }
+}
+
+/// Calculate the cross products of a and b
+template<typename T>
+void cross(vector_stream<T, 3> const& a, vector_stream<T, 3> const& b, vector_stream<T, 3>& out)
+{
+    KISMET_ASSERT(a.size() == b.size());
+    out.resize(a.size());
+
+    T const* ax = a.component(0);
+    T const* ay = a.component(1);
+    T const* az = a.component(2);
+    T const* bx = b.component(0);
+    T const* by = b.component(1);
+    T const* bz = b.component(2);
+    T* ox = out.component(0);
+    T* oy = out.component(1);
+    T* oz = out.component(2);
+
+    // the results of a block go through local arrays, so that the compiler does not
+    // need runtime alias checks between the 9 arrays, the stride is a multiple of the block
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = a.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T x[lanes];
+        T y[lanes];
+        T z[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            x[l] = ay[k] * bz[k] - az[k] * by[k];
+            y[l] = az[k] * bx[k] - ax[k] * bz[k];
+            z[l] = ax[k] * by[k] - ay[k] * bx[k];
+        }
+
+        std::copy_n(x, lanes, ox + first);
+        std::copy_n(y, lanes, oy + first);
+        std::copy_n(z, lanes, oz + first);
+    }
+}
+
+/// Normalize the vectors of v.
+/// If ok is not null, ok[k] is set to whether the k-th vector is normalized,
+/// a vector whose magnitude is less than tolerance is copied unchanged.
+/// Return true if all vectors are normalized.
+template<typename T, std::size_t N>
+bool normalize(vector_stream<T, N> const& v, vector_stream<T, N>& out,
+               bool* ok = nullptr, T tolerance = math_trait<T>::zero_tolerance())
+{
+    using std::sqrt;
+
+    out.resize(v.size());
+
+    T const* pv[N];
+    T* po[N];
+    for (std::size_t c = 0; c < N; ++c)
+    {
+        pv[c] = v.component(c);
+        po[c] = out.component(c);
+    }
+
+    T tolerance2 = tolerance * tolerance;
+
+    // blocked as in cross
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t size = v.size();
+    std::size_t count = v.stride();
+    bool all_ok = true;
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T scale[lanes];
+        T fail[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            T s = pv[0][k] * pv[0][k];
+            for (std::size_t c = 1; c < N; ++c)
+            {
+                s += pv[c][k] * pv[c][k];
+            }
+
+            // blend arithmetically, the scale of a failed vector is 1
+            fail[l] = s < tolerance2 ? T(1) : T(0);
+            scale[l] = (T(1) - fail[l]) / sqrt(s + fail[l]) + fail[l];
+        }
+
+        for (std::size_t c = 0; c < N; ++c)
+        {
+            for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+            {
+                po[c][k] = pv[c][k] * scale[l];
+            }
+        }
+
+        // the zero padding always fails, skip it
+        std::size_t valid = (std::min)(lanes, size - first);
+        for (std::size_t l = 0; l < valid; ++l)
+        {
+            bool normalized = fail[l] == T(0);
+            all_ok = all_ok & normalized;
+            if (ok)
+            {
+                ok[first + l] = normalized;
+            }
+        }
+    }
+
+    return all_ok;
+}
+
+/// Linearly interpolate v0 and v1 by t
+template<typename T, std::size_t N>
+void lerp(vector_stream<T, N> const& v0, vector_stream<T, N> const& v1, T t, vector_stream<T, N>& out)
+{
+    KISMET_ASSERT(v0.size() == v1.size());
+    out.resize(v0.size());
+
+    std::size_t count = v0.stride();
+    for (std::size_t c = 0; c < N; ++c)
+    {
+        T const* p0 = v0.component(c);
+        T const* p1 = v1.component(c);
+        T* po = out.component(c);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            po[k] = p0[k] + t * (p1[k] - p0[k]);
+        }
+    }
+}
+
+/// Linearly interpolate the k-th vectors of v0 and v1 by t[k],
+/// t must have v0.size() elements
+template<typename T, std::size_t N>
+void lerp(vector_stream<T, N> const& v0, vector_stream<T, N> const& v1, T const* t, vector_stream<T, N>& out)
+{
+    KISMET_ASSERT(v0.size() == v1.size());
+    out.resize(v0.size());
+
+    std::size_t count = v0.size();
+    for (std::size_t c = 0; c < N; ++c)
+    {
+        T const* p0 = v0.component(c);
+        T const* p1 = v1.component(c);
+        T* po = out.component(c);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            po[k] = p0[k] + t[k] * (p1[k] - p0[k]);
+        }
+    }
+}
+
+/// Reflect the incident vectors v off the surfaces with normals n, n must be unit vectors
+template<typename T, std::size_t N>
+void reflect(vector_stream<T, N> const& v, vector_stream<T, N> const& n, vector_stream<T, N>& out)
+{
+    KISMET_ASSERT(v.size() == n.size());
+    out.resize(v.size());
+
+    T const* pv[N];
+    T const* pn[N];
+    T* po[N];
+    for (std::size_t c = 0; c < N; ++c)
+    {
+        pv[c] = v.component(c);
+        pn[c] = n.component(c);
+        po[c] = out.component(c);
+    }
+
+    // blocked as in cross
+    const std::size_t lanes = detail::soa_lanes<T>::value;
+    std::size_t count = v.stride();
+    for (std::size_t first = 0; first < count; first += lanes)
+    {
+        T d[lanes];
+        for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+        {
+            T s = pv[0][k] * pn[0][k];
+            for (std::size_t c = 1; c < N; ++c)
+            {
+                s += pv[c][k] * pn[c][k];
+            }
+            d[l] = T(2) * s;
+        }
+
+        for (std::size_t c = 0; c < N; ++c)
+        {
+            for (std::size_t l = 0, k = first; l < lanes; ++l, ++k)
+            {
+                po[c][k] = pv[c][k] - d[l] * pn[c][k];
+            }
+        }
+    }
+}
+
+} // namespace math
+} // namespace kismet
+
+#endif // KISMET_MATH_VECTOR_STREAM_H
@@ -29,36 +29,68 @@
 namespace kismet
 {
 
-/// In-place reorder a range based on the given indices, indices will be modified.
-/// Index cannot be duplicate, otherwise behavior is undefined.
-template<typename RandIt, typename IndexRandIt>
-void reorder(RandIt start, RandIt end, IndexRandIt index_start)
+namespace detail
+{
+
+template<typename Index>
+inline void iter_swap_all(Index, Index)
+{
+}
+
+template<typename Index, typename RandIt, typename... RandIts>
+inline void iter_swap_all(Index i, Index j, RandIt start, RandIts... starts)
 {
     using std::iter_swap;
+    iter_swap(start + i, start + j);
+    iter_swap_all(i, j, starts...);
+}
+
+} // namespace detail
+
+/// In-place apply a permutation to all ranges which start at the given iterators, so that
+/// the i-th element of each range becomes the element which was at index_start[i].
+/// Use this to keep a structure of arrays in sync.
+/// The permutation is applied in O(N) by following its cycles. Indices are used to mark the
+/// placed elements, so they will be modified.
+/// Index cannot be duplicate, otherwise behavior is undefined.
+template<typename IndexRandIt, typename... RandIts>
+void apply_permutation(IndexRandIt index_start, IndexRandIt index_end, RandIts... starts)
+{
     using index_type = typename std::iterator_traits<IndexRandIt>::value_type;
 
-    KISMET_ASSERT(start <= end);
-    auto dist = static_cast<index_type>(end - start);
-    auto index_end = index_start + dist;
+    KISMET_ASSERT(index_start <= index_end);
+    auto dist = static_cast<index_type>(index_end - index_start);
 
-    for (index_type i = 0; i < dist; ++i, ++index_start)
+    for (index_type i = 0; i < dist; ++i)
     {
-        // if current item's index is not i
-        if (*index_start != i)
+        // walk the cycle which starts at i, every step brings the target item of j
+        // into place, and the item which was at i moves along to the next position.
+        index_type j = i;
+        index_type k = index_start[j];
+        while (k != i)
         {
-            // bring the target item into this place
-            iter_swap(start + i, start + *index_start);
-
-            // as current item has been move to index_start[i]
-            // we need to update its corresponding index so that
-            // it can be correctly found
-            auto it = std::find(index_start + 1, index_end, i);
-            KISMET_ASSERT(it != index_end);
-            *it = *index_start;
+            KISMET_ASSERT(k < dist);
+            detail::iter_swap_all(j, k, starts...);
+
+            // j is done, mark it so that it will be skipped later
+            index_start[j] = j;
+            j = k;
+            k = index_start[j];
         }
+        index_start[j] = j;
     }
 }
 
+/// In-place reorder a range based on the given indices, so that the i-th element
+/// becomes the element which was at index_start[i], indices will be modified.
+/// Index cannot be duplicate, otherwise behavior is undefined.
+template<typename RandIt, typename IndexRandIt>
+void reorder(RandIt start, RandIt end, IndexRandIt index_start)
+{
+    KISMET_ASSERT(start <= end);
+    apply_permutation(index_start, index_start + (end - start), start);
+}
+
 template<typename It>
 using iterator_value_t = typename std::iterator_traits<It>::value_type;
 
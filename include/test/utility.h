@@ -6,6 +6,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 
 namespace kismet
@@ -29,6 +30,23 @@ inline bool approx(InputIt1 start0, InputIt1 end0, InputIt2 start1)
     return std::equal(start0, end0, start1, approx_equal());
 }
 
+// Check that the padding of a batch or a stream is zero, so that growing it gives
+// zero elements
+template<typename Batch>
+inline void check_zero_padding(Batch b)
+{
+    std::size_t size = b.size();
+    std::size_t stride = b.stride();
+    b.resize(stride);
+    for (std::size_t k = size; k < stride; ++k)
+    {
+        for (auto v : b.get(k))
+        {
+            BOOST_CHECK_EQUAL(v, decltype(v)(0));
+        }
+    }
+}
+
 } // namespace test
 
 } // namespace kismet
@@ -0,0 +1,88 @@
+#include "kismet/ai/fuzzy/fuzzy_batch.h"
+
+namespace kismet
+{
+namespace fuzzy
+{
+namespace detail
+{
+
+// defined by the translation units in simd/, KISMET_SIMD_<ISA> is set by CMake
+// for the variants which are compiled in
+namespace scalar
+{
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n);
+}
+
+#ifdef KISMET_SIMD_SSE2
+namespace sse2
+{
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n);
+}
+#endif
+
+#ifdef KISMET_SIMD_AVX2
+namespace avx2
+{
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n);
+}
+#endif
+
+#ifdef KISMET_SIMD_AVX512
+namespace avx512
+{
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n);
+}
+#endif
+
+dom_trapezoid_kernel select_dom_trapezoid_kernel()
+{
+    simd_level level = active_simd_level();
+    for (;;)
+    {
+        if (dom_trapezoid_kernel kernel = find_dom_trapezoid_kernel(level))
+        {
+            return kernel;
+        }
+        level = static_cast<simd_level>(static_cast<int>(level) - 1);
+    }
+}
+
+} // namespace detail
+
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n)
+{
+    static const dom_trapezoid_kernel kernel = detail::select_dom_trapezoid_kernel();
+    kernel(m1, m2, m3, m4, input, dom, n);
+}
+
+dom_trapezoid_kernel find_dom_trapezoid_kernel(simd_level level)
+{
+    if (level > detect_simd_level())
+    {
+        return nullptr;
+    }
+
+    switch (level)
+    {
+    case simd_level::scalar:
+        return &detail::scalar::get_dom_trapezoid;
+#ifdef KISMET_SIMD_SSE2
+    case simd_level::sse2:
+        return &detail::sse2::get_dom_trapezoid;
+#endif
+#ifdef KISMET_SIMD_AVX2
+    case simd_level::avx2:
+        return &detail::avx2::get_dom_trapezoid;
+#endif
+#ifdef KISMET_SIMD_AVX512
+    case simd_level::avx512:
+        return &detail::avx512::get_dom_trapezoid;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+} // namespace fuzzy
+} // namespace kismet
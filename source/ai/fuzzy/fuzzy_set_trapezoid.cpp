@@ -46,7 +46,7 @@ float fuzzy_set_trapezoid::do_get_dom(float input) const
         KISMET_ASSERT(m_m3 < m_m4);
 
         float k = -1.0f / (m_m4 - m_m3);
-        return k * (input - m_m3);
+        return k * (input - m_m4);
     }
 
     return 0.0f;
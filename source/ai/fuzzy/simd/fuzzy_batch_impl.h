@@ -0,0 +1,45 @@
+// The batch kernels of one instruction set, included by the fuzzy_batch_<isa>.cpp
+// translation units after defining KISMET_SIMD_NAMESPACE to the name of the level.
+// The kernels use no header templates, so the variants cannot share symbols.
+
+#ifndef KISMET_SIMD_NAMESPACE
+#  error "KISMET_SIMD_NAMESPACE must be defined"
+#endif
+
+#include <cstddef>
+#include "kismet/core/assert.h"
+
+namespace kismet
+{
+namespace fuzzy
+{
+namespace detail
+{
+namespace KISMET_SIMD_NAMESPACE
+{
+
+// Both edges are evaluated for every input and clamped to [0, 1], a vertical edge
+// is a step. The variants ignore FP exceptions, so the selects are vectorized.
+void get_dom_trapezoid(float m1, float m2, float m3, float m4, float const* input, float* dom, std::size_t n)
+{
+    KISMET_ASSERT(m1 <= m2 && m2 <= m3 && m3 <= m4);
+
+    const bool rising = m1 < m2;
+    const bool falling = m3 < m4;
+    const float k1 = rising ? 1.0f / (m2 - m1) : 0.0f;
+    const float k2 = falling ? 1.0f / (m4 - m3) : 0.0f;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        float x = input[k];
+        float left = rising ? k1 * (x - m1) : (x >= m1 ? 1.0f : 0.0f);
+        float right = falling ? k2 * (m4 - x) : (x <= m4 ? 1.0f : 0.0f);
+        float d = left < right ? left : right;
+        d = d < 0.0f ? 0.0f : d;
+        dom[k] = d > 1.0f ? 1.0f : d;
+    }
+}
+
+} // namespace KISMET_SIMD_NAMESPACE
+} // namespace detail
+} // namespace fuzzy
+} // namespace kismet
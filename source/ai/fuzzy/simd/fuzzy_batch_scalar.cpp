@@ -0,0 +1,3 @@
+// The batch kernels compiled without auto-vectorization, the reference for the other levels
+#define KISMET_SIMD_NAMESPACE scalar
+#include "fuzzy_batch_impl.h"
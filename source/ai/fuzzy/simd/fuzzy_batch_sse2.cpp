@@ -0,0 +1,3 @@
+// The batch kernels compiled for SSE2, the x86-64 baseline
+#define KISMET_SIMD_NAMESPACE sse2
+#include "fuzzy_batch_impl.h"
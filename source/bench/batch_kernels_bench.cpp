@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "bench/utility.h"
+#include "kismet/math/batch_kernels.h"
+#include "kismet/math/quaternion.h"
+
+using namespace kismet;
+using namespace kismet::bench;
+using namespace kismet::math;
+
+namespace
+{
+
+// The kernels of the level given by the argument, null and the benchmark skipped
+// if the build or the CPU does not support it
+template<typename T>
+batch_kernels<T> const* kernels_of(benchmark::State& state)
+{
+    simd_level level = static_cast<simd_level>(state.range(0));
+    batch_kernels<T> const* kernels = find_batch_kernels<T>(level);
+    if (kernels == nullptr)
+    {
+        state.SkipWithError("level not supported");
+        return nullptr;
+    }
+    state.SetLabel(simd_level_name(level));
+    return kernels;
+}
+
+template<typename T>
+quaternion_stream<T> random_rotations(unsigned seed)
+{
+    std::mt19937 mt(seed);
+    std::vector<quaternion<T>> q(batch_size);
+    for (auto& e : q)
+    {
+        fill_random(e.begin(), e.end(), T(-1), T(1), mt);
+        e.normalize();
+    }
+    return quaternion_stream<T>(q.begin(), q.end());
+}
+
+template<typename T>
+void bm_kernels_rotate(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    std::mt19937 mt;
+    std::vector<vector3<T>> v(batch_size);
+    for (auto& e : v)
+    {
+        fill_random(e.begin(), e.end(), T(-1), T(1), mt);
+    }
+    quaternion_stream<T> sq = random_rotations<T>(1);
+    vector_stream<T, 3> sv(v.begin(), v.end());
+    vector_stream<T, 3> sc;
+    for (auto _ : state)
+    {
+        k->rotate(sq, sv, sc);
+        benchmark::DoNotOptimize(sc.component(0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 30);
+}
+
+template<typename T>
+void bm_kernels_slerp(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    quaternion_stream<T> sa = random_rotations<T>(1);
+    quaternion_stream<T> sb = random_rotations<T>(2);
+    quaternion_stream<T> sc;
+    std::vector<T> t(sa.stride(), T(0.3));
+    for (auto _ : state)
+    {
+        k->slerp(sa, sb, t.data(), sc);
+        benchmark::DoNotOptimize(sc.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_kernels_matrix_to_quat(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    matrix_batch<T, 4, 4> m;
+    k->matrix_rotate(random_rotations<T>(1), m);
+    quaternion_stream<T> sc;
+    for (auto _ : state)
+    {
+        k->matrix_to_quat(m, sc);
+        benchmark::DoNotOptimize(sc.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_kernels_solve(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    std::mt19937 mt;
+    matrix_batch<T, 4, 4> a(batch_size);
+    matrix_batch<T, 4, 1> b(batch_size);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            fill_random(a.element(i, j), a.element(i, j) + batch_size, T(-1), T(1), mt);
+        }
+        fill_random(b.element(i, 0), b.element(i, 0) + batch_size, T(-1), T(1), mt);
+    }
+    matrix_batch<T, 4, 1> x;
+    for (auto _ : state)
+    {
+        k->solve_partial_pivoting(a, b, x, nullptr, math_trait<T>::zero_tolerance());
+        benchmark::DoNotOptimize(x.element(0, 0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_kernels_eigen(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    std::mt19937 mt;
+    matrix_batch<T, 3, 3> a(batch_size);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j <= i; ++j)
+        {
+            fill_random(a.element(i, j), a.element(i, j) + batch_size, T(-1), T(1), mt);
+            std::copy_n(a.element(i, j), batch_size, a.element(j, i));
+        }
+    }
+    vector_stream<T, 3> values;
+    matrix_batch<T, 3, 3> vectors;
+    for (auto _ : state)
+    {
+        k->eigen_decompose_symmetric(a, values, vectors);
+        benchmark::DoNotOptimize(vectors.element(0, 0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_kernels_polar(benchmark::State& state)
+{
+    batch_kernels<T> const* k = kernels_of<T>(state);
+    if (k == nullptr)
+    {
+        return;
+    }
+
+    std::mt19937 mt;
+    matrix_batch<T, 3, 3> a(batch_size);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            fill_random(a.element(i, j), a.element(i, j) + batch_size, T(-1), T(1), mt);
+        }
+    }
+    matrix_batch<T, 3, 3> r;
+    matrix_batch<T, 3, 3> s;
+    for (auto _ : state)
+    {
+        k->polar_decompose(a, r, s);
+        benchmark::DoNotOptimize(r.element(0, 0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+// one run per simd_level
+void levels(benchmark::internal::Benchmark* b)
+{
+    b->DenseRange(static_cast<int>(simd_level::scalar), static_cast<int>(simd_level::avx512));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_kernels_rotate, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_rotate, double)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_slerp, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_slerp, double)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_matrix_to_quat, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_matrix_to_quat, double)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_solve, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_solve, double)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_eigen, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_eigen, double)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_polar, float)->Apply(levels);
+BENCHMARK_TEMPLATE(bm_kernels_polar, double)->Apply(levels);
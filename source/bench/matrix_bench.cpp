@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "bench/utility.h"
+#include "kismet/math/linear_system.h"
+#include "kismet/math/matrix.h"
+
+using namespace kismet::bench;
+using namespace kismet::math;
+
+namespace
+{
+
+// random matrices with a dominant diagonal, so that they are well conditioned
+template<typename T, std::size_t N>
+std::vector<matrix<T, N, N>> random_matrices(std::size_t n)
+{
+    std::mt19937 mt;
+    std::vector<matrix<T, N, N>> m(n);
+    for (auto& e : m)
+    {
+        fill_random(e.data(), e.data() + N * N, T(-1), T(1), mt);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            e[i][i] += T(N);
+        }
+    }
+    return m;
+}
+
+// random_matrices with shuffled rows, so that the pivot rows are unpredictable
+template<typename T, std::size_t N>
+std::vector<matrix<T, N, N>> shuffled_matrices(std::size_t n)
+{
+    std::mt19937 mt(2);
+    auto m = random_matrices<T, N>(n);
+    std::size_t rows[N];
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        rows[i] = i;
+    }
+    for (auto& e : m)
+    {
+        std::shuffle(rows, rows + N, mt);
+        matrix<T, N, N> t = e;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                e[i][j] = t[rows[i]][j];
+            }
+        }
+    }
+    return m;
+}
+
+template<typename T, std::size_t N>
+std::vector<matrix<T, N, 1>> random_vectors(std::size_t n)
+{
+    std::mt19937 mt(1);
+    std::vector<matrix<T, N, 1>> v(n);
+    for (auto& e : v)
+    {
+        fill_random(e.data(), e.data() + N, T(-1), T(1), mt);
+    }
+    return v;
+}
+
+template<typename T, std::size_t N>
+void bm_matrix_multiply(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_matrices<T, N>(batch_size);
+    std::vector<matrix<T, N, N>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = a[k] * b[k];
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N - N * N);
+}
+
+// writes into c without the temporary of operator *, compare with bm_matrix_multiply
+template<typename T, std::size_t N>
+void bm_matrix_multiply_into(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_matrices<T, N>(batch_size);
+    std::vector<matrix<T, N, N>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            multiply_into(c[k], a[k], b[k]);
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N - N * N);
+}
+
+template<typename T, std::size_t N>
+void bm_matrix_transpose(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            a[k] = transpose(a[k]);
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T, std::size_t N>
+void bm_matrix_transpose_inplace(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            transpose_inplace(a[k]);
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T, std::size_t N>
+void bm_matrix_invert(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    std::vector<matrix<T, N, N>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            benchmark::DoNotOptimize(invert(a[k], c[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    // PLU and the inverses of both triangles
+    set_counters(state, batch_size, 2.0 * N * N * N);
+}
+
+template<typename T, std::size_t N>
+void bm_plu_decompose(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    std::vector<matrix<T, N, N>> l(batch_size);
+    std::vector<matrix<T, N, N>> u(batch_size);
+    std::size_t p[N];
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            plu_decompose(a[k], p, l[k], u[k]);
+            benchmark::DoNotOptimize(p);
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0);
+}
+
+template<typename T, std::size_t N>
+void bm_plu_decompose_packed(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    std::vector<matrix<T, N, N>> lu(batch_size);
+    std::size_t p[N];
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            plu_decompose_packed(a[k], p, lu[k]);
+            benchmark::DoNotOptimize(p);
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0);
+}
+
+template<typename T, std::size_t N>
+void bm_solve_partial_pivoting(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            benchmark::DoNotOptimize(solve_partial_pivoting(a[k], b[k], x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0 + 2.0 * N * N);
+}
+
+// decompose and solve shuffled systems, compare with bm_plu_solve_branchless
+template<typename T, std::size_t N>
+void bm_plu_solve(benchmark::State& state)
+{
+    auto a = shuffled_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    matrix<T, N, N> lu;
+    std::size_t p[N];
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            plu_decompose_packed(a[k], p, lu);
+            benchmark::DoNotOptimize(plu_solve(lu, p, b[k], x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0 + 2.0 * N * N);
+}
+
+template<typename T, std::size_t N>
+void bm_plu_solve_branchless(benchmark::State& state)
+{
+    auto a = shuffled_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    matrix<T, N, N> lu;
+    std::size_t p[N];
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            plu_decompose_packed_branchless(a[k], p, lu);
+            benchmark::DoNotOptimize(plu_solve_branchless(lu, p, b[k], x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0 + 2.0 * N * N);
+}
+
+// systems assembled into scratch matrices which are not needed after the solve,
+// compare with bm_solve_assembled_inplace
+template<typename T, std::size_t N>
+void bm_solve_assembled(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    matrix<T, N, N> sys;
+    matrix<T, N, 1> rhs;
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            sys = a[k];
+            rhs = b[k];
+            benchmark::DoNotOptimize(solve_partial_pivoting(sys, rhs, x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0 + 2.0 * N * N);
+}
+
+template<typename T, std::size_t N>
+void bm_solve_assembled_inplace(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    matrix<T, N, N> sys;
+    matrix<T, N, 1> rhs;
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            sys = a[k];
+            rhs = b[k];
+            benchmark::DoNotOptimize(solve_partial_pivoting_inplace(sys, rhs, x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 2.0 * N * N * N / 3.0 + 2.0 * N * N);
+}
+
+// double systems factored in float, compare with bm_solve_partial_pivoting<double>
+template<typename T, std::size_t N>
+void bm_solve_mixed_precision(benchmark::State& state)
+{
+    auto a = random_matrices<T, N>(batch_size);
+    auto b = random_vectors<T, N>(batch_size);
+    std::vector<matrix<T, N, 1>> x(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            benchmark::DoNotOptimize(solve_mixed_precision(a[k], b[k], x[k]));
+        }
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+} // namespace
+
+#define KISMET_BENCH_SQUARE(bm, T) \
+    BENCHMARK_TEMPLATE(bm, T, 2);  \
+    BENCHMARK_TEMPLATE(bm, T, 3);  \
+    BENCHMARK_TEMPLATE(bm, T, 4);  \
+    BENCHMARK_TEMPLATE(bm, T, 5);  \
+    BENCHMARK_TEMPLATE(bm, T, 6);  \
+    BENCHMARK_TEMPLATE(bm, T, 7);  \
+    BENCHMARK_TEMPLATE(bm, T, 8)
+
+// the sizes where copies of whole matrices are noticeable
+#define KISMET_BENCH_LARGE(bm, T)   \
+    BENCHMARK_TEMPLATE(bm, T, 8);  \
+    BENCHMARK_TEMPLATE(bm, T, 12); \
+    BENCHMARK_TEMPLATE(bm, T, 16)
+
+KISMET_BENCH_SQUARE(bm_matrix_multiply, float);
+KISMET_BENCH_SQUARE(bm_matrix_multiply, double);
+KISMET_BENCH_SQUARE(bm_matrix_invert, float);
+KISMET_BENCH_SQUARE(bm_matrix_invert, double);
+KISMET_BENCH_SQUARE(bm_plu_decompose, float);
+KISMET_BENCH_SQUARE(bm_plu_decompose, double);
+KISMET_BENCH_SQUARE(bm_plu_decompose_packed, float);
+KISMET_BENCH_SQUARE(bm_plu_decompose_packed, double);
+KISMET_BENCH_SQUARE(bm_solve_partial_pivoting, float);
+KISMET_BENCH_SQUARE(bm_solve_partial_pivoting, double);
+KISMET_BENCH_SQUARE(bm_plu_solve, float);
+KISMET_BENCH_SQUARE(bm_plu_solve, double);
+KISMET_BENCH_SQUARE(bm_plu_solve_branchless, float);
+KISMET_BENCH_SQUARE(bm_plu_solve_branchless, double);
+KISMET_BENCH_SQUARE(bm_solve_mixed_precision, double);
+BENCHMARK_TEMPLATE(bm_matrix_multiply, float, 12);
+BENCHMARK_TEMPLATE(bm_matrix_multiply, float, 16);
+BENCHMARK_TEMPLATE(bm_matrix_multiply, double, 12);
+BENCHMARK_TEMPLATE(bm_matrix_multiply, double, 16);
+KISMET_BENCH_LARGE(bm_matrix_multiply_into, float);
+KISMET_BENCH_LARGE(bm_matrix_multiply_into, double);
+KISMET_BENCH_LARGE(bm_matrix_transpose, float);
+KISMET_BENCH_LARGE(bm_matrix_transpose, double);
+KISMET_BENCH_LARGE(bm_matrix_transpose_inplace, float);
+KISMET_BENCH_LARGE(bm_matrix_transpose_inplace, double);
+KISMET_BENCH_LARGE(bm_solve_assembled, float);
+KISMET_BENCH_LARGE(bm_solve_assembled, double);
+KISMET_BENCH_LARGE(bm_solve_assembled_inplace, float);
+KISMET_BENCH_LARGE(bm_solve_assembled_inplace, double);
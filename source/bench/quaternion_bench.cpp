@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "bench/utility.h"
+#include "kismet/math/quaternion.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/vector_stream.h"
+
+using namespace kismet::bench;
+using namespace kismet::math;
+
+namespace
+{
+
+template<typename T>
+std::vector<quaternion<T>> random_rotations(std::size_t n, unsigned seed)
+{
+    std::mt19937 mt(seed);
+    std::vector<quaternion<T>> q(n);
+    for (auto& e : q)
+    {
+        fill_random(e.begin(), e.end(), T(-1), T(1), mt);
+        e.normalize();
+    }
+    return q;
+}
+
+template<typename T>
+std::vector<vector3<T>> random_vectors(std::size_t n)
+{
+    std::mt19937 mt;
+    std::vector<vector3<T>> v(n);
+    for (auto& e : v)
+    {
+        fill_random(e.begin(), e.end(), T(-1), T(1), mt);
+    }
+    return v;
+}
+
+template<typename T>
+void bm_quaternion_rotate(benchmark::State& state)
+{
+    auto q = random_rotations<T>(batch_size, 1);
+    auto v = random_vectors<T>(batch_size);
+    std::vector<vector3<T>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = q[k] * v[k];
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 30);
+}
+
+template<typename T>
+void bm_quaternion_slerp(benchmark::State& state)
+{
+    auto a = random_rotations<T>(batch_size, 1);
+    auto b = random_rotations<T>(batch_size, 2);
+    std::vector<quaternion<T>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = slerp(a[k], b[k], T(0.3));
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_quaternion_stream_rotate(benchmark::State& state)
+{
+    auto q = random_rotations<T>(batch_size, 1);
+    auto v = random_vectors<T>(batch_size);
+    quaternion_stream<T> sq(q.begin(), q.end());
+    vector_stream<T, 3> sv(v.begin(), v.end());
+    vector_stream<T, 3> sc;
+    for (auto _ : state)
+    {
+        rotate(sq, sv, sc);
+        benchmark::DoNotOptimize(sc.component(0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 30);
+}
+
+template<typename T>
+void bm_quaternion_stream_slerp(benchmark::State& state)
+{
+    auto a = random_rotations<T>(batch_size, 1);
+    auto b = random_rotations<T>(batch_size, 2);
+    quaternion_stream<T> sa(a.begin(), a.end());
+    quaternion_stream<T> sb(b.begin(), b.end());
+    quaternion_stream<T> sc;
+    std::vector<T> t(batch_size, T(0.3));
+    for (auto _ : state)
+    {
+        slerp(sa, sb, t.data(), sc);
+        benchmark::DoNotOptimize(sc.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_quaternion_stream_slerp_shared(benchmark::State& state)
+{
+    auto a = random_rotations<T>(batch_size, 1);
+    auto b = random_rotations<T>(batch_size, 2);
+    quaternion_stream<T> sa(a.begin(), a.end());
+    quaternion_stream<T> sb(b.begin(), b.end());
+    quaternion_stream<T> sc;
+    for (auto _ : state)
+    {
+        slerp(sa, sb, T(0.3), sc);
+        benchmark::DoNotOptimize(sc.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_quaternion_rotate, float);
+BENCHMARK_TEMPLATE(bm_quaternion_rotate, double);
+BENCHMARK_TEMPLATE(bm_quaternion_slerp, float);
+BENCHMARK_TEMPLATE(bm_quaternion_slerp, double);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_rotate, float);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_rotate, double);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_slerp, float);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_slerp, double);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_slerp_shared, float);
+BENCHMARK_TEMPLATE(bm_quaternion_stream_slerp_shared, double);
@@ -0,0 +1,188 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "bench/utility.h"
+#include "kismet/math/transform.h"
+#include "kismet/math/transform_batch.h"
+
+using namespace kismet::bench;
+using namespace kismet::math;
+
+namespace
+{
+
+template<typename T>
+std::vector<vector3<T>> random_angles(std::size_t n)
+{
+    std::mt19937 mt;
+    std::vector<vector3<T>> e(n);
+    for (auto& v : e)
+    {
+        fill_random(v.begin(), v.end(), T(-3), T(3), mt);
+    }
+    return e;
+}
+
+template<typename T>
+std::vector<quaternion<T>> random_rotations(std::size_t n)
+{
+    std::vector<quaternion<T>> q;
+    for (auto const& e : random_angles<T>(n))
+    {
+        q.push_back(quat_from_euler_yxz(e));
+    }
+    return q;
+}
+
+template<typename T>
+void bm_euler_to_matrix(benchmark::State& state)
+{
+    auto e = random_angles<T>(batch_size);
+    std::vector<matrix44<T>> m(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            m[k] = euler_yxz_to_matrix(e[k]);
+        }
+        benchmark::DoNotOptimize(m.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_euler_to_quaternion(benchmark::State& state)
+{
+    auto e = random_angles<T>(batch_size);
+    std::vector<quaternion<T>> q(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            q[k] = quat_from_euler_yxz(e[k]);
+        }
+        benchmark::DoNotOptimize(q.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_quaternion_to_matrix(benchmark::State& state)
+{
+    auto q = random_rotations<T>(batch_size);
+    std::vector<matrix44<T>> m(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            m[k] = matrix_rotate(q[k]);
+        }
+        benchmark::DoNotOptimize(m.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_matrix_to_quaternion(benchmark::State& state)
+{
+    std::vector<matrix44<T>> m;
+    for (auto const& q : random_rotations<T>(batch_size))
+    {
+        m.push_back(matrix_rotate(q));
+    }
+    std::vector<quaternion<T>> q(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            q[k] = matrix_to_quat(m[k]);
+        }
+        benchmark::DoNotOptimize(q.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_batch_euler_to_matrix(benchmark::State& state)
+{
+    auto e = random_angles<T>(batch_size);
+    vector_stream<T, 3> se(e.begin(), e.end());
+    matrix_batch<T, 4, 4> m;
+    for (auto _ : state)
+    {
+        euler_yxz_to_matrix(se, m);
+        benchmark::DoNotOptimize(m.element(0, 0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_batch_euler_to_quaternion(benchmark::State& state)
+{
+    auto e = random_angles<T>(batch_size);
+    vector_stream<T, 3> se(e.begin(), e.end());
+    quaternion_stream<T> q;
+    for (auto _ : state)
+    {
+        quat_from_euler_yxz(se, q);
+        benchmark::DoNotOptimize(q.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_batch_quaternion_to_matrix(benchmark::State& state)
+{
+    auto q = random_rotations<T>(batch_size);
+    quaternion_stream<T> sq(q.begin(), q.end());
+    matrix_batch<T, 4, 4> m;
+    for (auto _ : state)
+    {
+        matrix_rotate(sq, m);
+        benchmark::DoNotOptimize(m.element(0, 0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+template<typename T>
+void bm_batch_matrix_to_quaternion(benchmark::State& state)
+{
+    auto q = random_rotations<T>(batch_size);
+    quaternion_stream<T> sq(q.begin(), q.end());
+    matrix_batch<T, 4, 4> m;
+    matrix_rotate(sq, m);
+    for (auto _ : state)
+    {
+        matrix_to_quat(m, sq);
+        benchmark::DoNotOptimize(sq.w());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_euler_to_matrix, float);
+BENCHMARK_TEMPLATE(bm_euler_to_matrix, double);
+BENCHMARK_TEMPLATE(bm_euler_to_quaternion, float);
+BENCHMARK_TEMPLATE(bm_euler_to_quaternion, double);
+BENCHMARK_TEMPLATE(bm_quaternion_to_matrix, float);
+BENCHMARK_TEMPLATE(bm_quaternion_to_matrix, double);
+BENCHMARK_TEMPLATE(bm_matrix_to_quaternion, float);
+BENCHMARK_TEMPLATE(bm_matrix_to_quaternion, double);
+BENCHMARK_TEMPLATE(bm_batch_euler_to_matrix, float);
+BENCHMARK_TEMPLATE(bm_batch_euler_to_matrix, double);
+BENCHMARK_TEMPLATE(bm_batch_euler_to_quaternion, float);
+BENCHMARK_TEMPLATE(bm_batch_euler_to_quaternion, double);
+BENCHMARK_TEMPLATE(bm_batch_quaternion_to_matrix, float);
+BENCHMARK_TEMPLATE(bm_batch_quaternion_to_matrix, double);
+BENCHMARK_TEMPLATE(bm_batch_matrix_to_quaternion, float);
+BENCHMARK_TEMPLATE(bm_batch_matrix_to_quaternion, double);
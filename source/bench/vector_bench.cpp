@@ -0,0 +1,142 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "bench/utility.h"
+#include "kismet/math/vector.h"
+#include "kismet/math/vector_stream.h"
+
+using namespace kismet::bench;
+using namespace kismet::math;
+
+namespace
+{
+
+template<typename T>
+std::vector<vector3<T>> random_vectors(std::size_t n, unsigned seed)
+{
+    std::mt19937 mt(seed);
+    std::vector<vector3<T>> v(n);
+    for (auto& e : v)
+    {
+        fill_random(e.begin(), e.end(), T(-1), T(1), mt);
+    }
+    return v;
+}
+
+template<typename T>
+void bm_vector_dot(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    auto b = random_vectors<T>(batch_size, 2);
+    std::vector<T> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = dot(a[k], b[k]);
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 5);
+}
+
+template<typename T>
+void bm_vector_cross(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    auto b = random_vectors<T>(batch_size, 2);
+    std::vector<vector3<T>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = cross(a[k], b[k]);
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 9);
+}
+
+template<typename T>
+void bm_vector_normalize(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    std::vector<vector3<T>> c(batch_size);
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            c[k] = normalize(a[k]);
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    // squared magnitude, square root, reciprocal and scale
+    set_counters(state, batch_size, 10);
+}
+
+template<typename T>
+void bm_vector_stream_dot(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    auto b = random_vectors<T>(batch_size, 2);
+    vector_stream<T, 3> sa(a.begin(), a.end());
+    vector_stream<T, 3> sb(b.begin(), b.end());
+    std::vector<T> c(batch_size);
+    for (auto _ : state)
+    {
+        dot(sa, sb, c.data());
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 5);
+}
+
+template<typename T>
+void bm_vector_stream_cross(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    auto b = random_vectors<T>(batch_size, 2);
+    vector_stream<T, 3> sa(a.begin(), a.end());
+    vector_stream<T, 3> sb(b.begin(), b.end());
+    vector_stream<T, 3> sc;
+    for (auto _ : state)
+    {
+        cross(sa, sb, sc);
+        benchmark::DoNotOptimize(sc.component(0));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 9);
+}
+
+template<typename T>
+void bm_vector_stream_normalize(benchmark::State& state)
+{
+    auto a = random_vectors<T>(batch_size, 1);
+    vector_stream<T, 3> sa(a.begin(), a.end());
+    vector_stream<T, 3> sc;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(normalize(sa, sc));
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, batch_size, 10);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_vector_dot, float);
+BENCHMARK_TEMPLATE(bm_vector_dot, double);
+BENCHMARK_TEMPLATE(bm_vector_cross, float);
+BENCHMARK_TEMPLATE(bm_vector_cross, double);
+BENCHMARK_TEMPLATE(bm_vector_normalize, float);
+BENCHMARK_TEMPLATE(bm_vector_normalize, double);
+BENCHMARK_TEMPLATE(bm_vector_stream_dot, float);
+BENCHMARK_TEMPLATE(bm_vector_stream_dot, double);
+BENCHMARK_TEMPLATE(bm_vector_stream_cross, float);
+BENCHMARK_TEMPLATE(bm_vector_stream_cross, double);
+BENCHMARK_TEMPLATE(bm_vector_stream_normalize, float);
+BENCHMARK_TEMPLATE(bm_vector_stream_normalize, double);
@@ -0,0 +1,99 @@
+#include "kismet/math/batch_kernels.h"
+
+namespace kismet
+{
+
+namespace math
+{
+
+namespace detail
+{
+
+// defined by the translation units in simd/, KISMET_SIMD_<ISA> is set by CMake
+// for the variants which are compiled in
+namespace scalar
+{
+template<typename T> batch_kernels<T> const& get_kernels();
+}
+
+#ifdef KISMET_SIMD_SSE2
+namespace sse2
+{
+template<typename T> batch_kernels<T> const& get_kernels();
+}
+#endif
+
+#ifdef KISMET_SIMD_AVX2
+namespace avx2
+{
+template<typename T> batch_kernels<T> const& get_kernels();
+}
+#endif
+
+#ifdef KISMET_SIMD_AVX512
+namespace avx512
+{
+template<typename T> batch_kernels<T> const& get_kernels();
+}
+#endif
+
+template<typename T>
+batch_kernels<T> const& select_kernels()
+{
+    simd_level level = active_simd_level();
+    for (;;)
+    {
+        if (batch_kernels<T> const* kernels = find_batch_kernels<T>(level))
+        {
+            return *kernels;
+        }
+        level = static_cast<simd_level>(static_cast<int>(level) - 1);
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+batch_kernels<T> const* find_batch_kernels(simd_level level)
+{
+    if (level > detect_simd_level())
+    {
+        return nullptr;
+    }
+
+    switch (level)
+    {
+    case simd_level::scalar:
+        return &detail::scalar::get_kernels<T>();
+#ifdef KISMET_SIMD_SSE2
+    case simd_level::sse2:
+        return &detail::sse2::get_kernels<T>();
+#endif
+#ifdef KISMET_SIMD_AVX2
+    case simd_level::avx2:
+        return &detail::avx2::get_kernels<T>();
+#endif
+#ifdef KISMET_SIMD_AVX512
+    case simd_level::avx512:
+        return &detail::avx512::get_kernels<T>();
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+template<typename T>
+batch_kernels<T> const& get_batch_kernels()
+{
+    static batch_kernels<T> const& kernels = detail::select_kernels<T>();
+    return kernels;
+}
+
+template batch_kernels<float> const* find_batch_kernels<float>(simd_level);
+template batch_kernels<double> const* find_batch_kernels<double>(simd_level);
+template batch_kernels<float> const& get_batch_kernels<float>();
+template batch_kernels<double> const& get_batch_kernels<double>();
+
+} // namespace math
+
+} // namespace kismet
@@ -0,0 +1,3 @@
+// The batch kernels compiled for AVX2 and FMA
+#define KISMET_SIMD_NAMESPACE avx2
+#include "batch_kernels_impl.h"
@@ -0,0 +1,3 @@
+// The batch kernels compiled for AVX-512 with 512-bit vectors
+#define KISMET_SIMD_NAMESPACE avx512
+#include "batch_kernels_impl.h"
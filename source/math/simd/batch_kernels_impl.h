@@ -0,0 +1,156 @@
+// The batch kernel table of one instruction set, included by the batch_kernels_<isa>.cpp
+// translation units after defining KISMET_SIMD_NAMESPACE to the name of the level.
+// Those are compiled with the flags of their instruction set, see kismet_simd_sources in
+// the top CMakeLists.txt.
+//
+// The templates of the headers are instantiated in every variant, and the linker would keep
+// an arbitrary one of the identical symbols. The wrappers are therefore flattened, so that
+// the variant code is inlined into functions of this namespace only.
+
+#ifndef KISMET_SIMD_NAMESPACE
+#  error "KISMET_SIMD_NAMESPACE must be defined"
+#endif
+
+#include "kismet/config.h"
+#include "kismet/math/batch_kernels.h"
+#include "kismet/math/eigen.h"
+#include "kismet/math/linear_system_batch.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/svd.h"
+#include "kismet/math/transform_batch.h"
+#include "kismet/math/vector_stream.h"
+
+#if defined(KISMET_GCC)
+#  define KISMET_SIMD_KERNEL __attribute__((flatten))
+#else
+#  define KISMET_SIMD_KERNEL
+#endif
+
+namespace kismet
+{
+namespace math
+{
+namespace detail
+{
+namespace KISMET_SIMD_NAMESPACE
+{
+namespace
+{
+
+template<typename T>
+KISMET_SIMD_KERNEL void dot(vector_stream<T, 3> const& a, vector_stream<T, 3> const& b, T* out)
+{
+    math::dot(a, b, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void cross(vector_stream<T, 3> const& a, vector_stream<T, 3> const& b, vector_stream<T, 3>& out)
+{
+    math::cross(a, b, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL bool normalize(vector_stream<T, 3> const& v, vector_stream<T, 3>& out, bool* ok, T tolerance)
+{
+    return math::normalize(v, out, ok, tolerance);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void rotate(quaternion_stream<T> const& q, vector_stream<T, 3> const& v, vector_stream<T, 3>& out)
+{
+    math::rotate(q, v, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void multiply(quaternion_stream<T> const& a, quaternion_stream<T> const& b,
+                                 quaternion_stream<T>& out)
+{
+    math::multiply(a, b, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void slerp(quaternion_stream<T> const& q0, quaternion_stream<T> const& q1, T const* t,
+                              quaternion_stream<T>& out)
+{
+    math::slerp(q0, q1, t, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void quat_from_euler_yxz(vector_stream<T, 3> const& e, quaternion_stream<T>& out)
+{
+    math::quat_from_euler_yxz(e, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void matrix_rotate(quaternion_stream<T> const& q, matrix_batch<T, 4, 4>& out)
+{
+    math::matrix_rotate(q, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void matrix_to_quat(matrix_batch<T, 4, 4> const& m, quaternion_stream<T>& out)
+{
+    math::matrix_to_quat(m, out);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL bool solve_partial_pivoting(matrix_batch<T, 4, 4> const& a, matrix_batch<T, 4, 1> const& b,
+                                               matrix_batch<T, 4, 1>& x, bool* ok, T tolerance)
+{
+    return math::solve_partial_pivoting(a, b, x, ok, tolerance);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void eigen_decompose_symmetric(matrix_batch<T, 3, 3> const& a, vector_stream<T, 3>& values,
+                                                  matrix_batch<T, 3, 3>& vectors)
+{
+    math::eigen_decompose_symmetric(a, values, vectors);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void svd_decompose(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& u,
+                                      vector_stream<T, 3>& sigma, matrix_batch<T, 3, 3>& v)
+{
+    math::svd_decompose(a, u, sigma, v);
+}
+
+template<typename T>
+KISMET_SIMD_KERNEL void polar_decompose(matrix_batch<T, 3, 3> const& a, matrix_batch<T, 3, 3>& r,
+                                        matrix_batch<T, 3, 3>& s)
+{
+    math::polar_decompose(a, r, s);
+}
+
+} // namespace
+
+template<typename T>
+batch_kernels<T> const& get_kernels()
+{
+    static const batch_kernels<T> kernels = {
+        simd_level::KISMET_SIMD_NAMESPACE,
+        &dot<T>,
+        &cross<T>,
+        &normalize<T>,
+        &rotate<T>,
+        &multiply<T>,
+        &slerp<T>,
+        &quat_from_euler_yxz<T>,
+        &matrix_rotate<T>,
+        &matrix_to_quat<T>,
+        &solve_partial_pivoting<T>,
+        &eigen_decompose_symmetric<T>,
+        &svd_decompose<T>,
+        &polar_decompose<T>
+    };
+    return kernels;
+}
+
+template batch_kernels<float> const& get_kernels<float>();
+template batch_kernels<double> const& get_kernels<double>();
+
+} // namespace KISMET_SIMD_NAMESPACE
+} // namespace detail
+} // namespace math
+} // namespace kismet
+
+#undef KISMET_SIMD_KERNEL
@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/core/aligned_allocator.h"
+#include "kismet/math/aligned.h"
+#include "kismet/math/matrix_batch.h"
+#include "test/utility.h"
+
+using namespace kismet;
+using namespace kismet::math;
+
+namespace
+{
+
+bool is_aligned(void const* p, std::size_t align)
+{
+    return (reinterpret_cast<std::uintptr_t>(p) & (align - 1)) == 0;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(aligned_test)
+
+BOOST_AUTO_TEST_CASE(aligned_layout)
+{
+    static_assert(sizeof(aligned_vector3f) == 16 && alignof(aligned_vector3f) == 16, "vector3f is padded to 4 lanes");
+    static_assert(sizeof(aligned_vector3d) == 32 && alignof(aligned_vector3d) == 32, "vector3d is padded to 4 lanes");
+    static_assert(sizeof(aligned_vector4f) == 16 && alignof(aligned_vector4f) == 16, "vector4f is not padded");
+    static_assert(alignof(aligned_matrix44f) == 32, "alignment is capped to 32 bytes");
+    static_assert(sizeof(aligned<vector3f, 32>) == 32, "explicit alignment");
+}
+
+BOOST_AUTO_TEST_CASE(aligned_conversion)
+{
+    aligned_vector3f a(1.0f, 2.0f, 3.0f);
+    vector3f b(4.0f, 5.0f, 6.0f);
+
+    aligned_vector3f c = a + b;
+    KISMET_CHECK_APPROX_COLLECTIONS(c, vector3f(5.0f, 7.0f, 9.0f));
+
+    c = a.cross(b);
+    KISMET_CHECK_APPROX_COLLECTIONS(c, vector3f(-3.0f, 6.0f, -3.0f));
+    BOOST_CHECK(approx(dot(c, b), 0.0f));
+}
+
+BOOST_AUTO_TEST_CASE(aligned_allocator_container)
+{
+    std::vector<aligned_vector3d, aligned_allocator<aligned_vector3d>> v;
+    for (int i = 0; i < 100; ++i)
+    {
+        v.emplace_back(double(i), 0.0, 0.0);
+        BOOST_CHECK(is_aligned(v.data(), 32));
+    }
+    BOOST_CHECK_EQUAL(v[99].x(), 99.0);
+
+    std::vector<float, aligned_allocator<float, 64>> f(3);
+    BOOST_CHECK(is_aligned(f.data(), 64));
+}
+
+BOOST_AUTO_TEST_CASE(aligned_matrix_batch)
+{
+    matrix_batch<float, 3, 3> batch(37);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            BOOST_CHECK(is_aligned(batch.element(i, j), 64));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,306 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/core/cpu.h"
+#include "kismet/math/batch_kernels.h"
+#include "kismet/math/transform.h"
+#include "test/utility.h"
+
+using namespace kismet;
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t batch_size = 37;
+
+const simd_level all_levels[] = { simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512 };
+
+void check_approx(float const* a, float const* exp_a, std::size_t n, float tolerance)
+{
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        BOOST_CHECK(approx(a[k], exp_a[k], tolerance));
+    }
+}
+
+template<std::size_t N>
+void check_approx(vector_stream<float, N> const& v, vector_stream<float, N> const& exp_v, float tolerance)
+{
+    BOOST_REQUIRE_EQUAL(v.size(), exp_v.size());
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        check_approx(v.component(i), exp_v.component(i), v.size(), tolerance);
+    }
+}
+
+void check_approx(quaternion_stream<float> const& q, quaternion_stream<float> const& exp_q, float tolerance)
+{
+    BOOST_REQUIRE_EQUAL(q.size(), exp_q.size());
+    check_approx(q.w(), exp_q.w(), q.size(), tolerance);
+    check_approx(q.x(), exp_q.x(), q.size(), tolerance);
+    check_approx(q.y(), exp_q.y(), q.size(), tolerance);
+    check_approx(q.z(), exp_q.z(), q.size(), tolerance);
+}
+
+template<std::size_t N1, std::size_t N2>
+void check_approx(matrix_batch<float, N1, N2> const& m, matrix_batch<float, N1, N2> const& exp_m, float tolerance)
+{
+    BOOST_REQUIRE_EQUAL(m.size(), exp_m.size());
+    for (std::size_t i = 0; i < N1; ++i)
+    {
+        for (std::size_t j = 0; j < N2; ++j)
+        {
+            check_approx(m.element(i, j), exp_m.element(i, j), m.size(), tolerance);
+        }
+    }
+}
+
+struct kernel_inputs
+{
+    kernel_inputs()
+    {
+        std::mt19937 mt;
+        std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+        std::vector<vector3f> va(batch_size);
+        std::vector<vector3f> vb(batch_size);
+        std::vector<quaternionf> qa(batch_size);
+        std::vector<quaternionf> qb(batch_size);
+        t.resize(batch_size);
+        a.resize(batch_size);
+        b.resize(batch_size);
+        symmetric.resize(batch_size);
+        a3.resize(batch_size);
+        for (std::size_t k = 0; k < batch_size; ++k)
+        {
+            va[k] = vector3f(dis(mt), dis(mt), dis(mt));
+            vb[k] = vector3f(dis(mt), dis(mt), dis(mt));
+            qa[k] = quaternionf(dis(mt), dis(mt), dis(mt), dis(mt));
+            qa[k].normalize();
+            qb[k] = quaternionf(dis(mt), dis(mt), dis(mt), dis(mt));
+            qb[k].normalize();
+            t[k] = dis(mt) * 0.5f + 0.5f;
+
+            matrix44<float> m;
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    m[i][j] = dis(mt) + (i == j ? 4.0f : 0.0f);
+                }
+            }
+            a.set(k, m);
+            float r[] = { dis(mt), dis(mt), dis(mt), dis(mt) };
+            b.set(k, matrix<float, 4, 1>(r, r + 4));
+
+            matrix33f s;
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                for (std::size_t j = 0; j <= i; ++j)
+                {
+                    s[i][j] = s[j][i] = dis(mt);
+                }
+            }
+            symmetric.set(k, s);
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    s[i][j] = m[i][j];
+                }
+            }
+            a3.set(k, s);
+        }
+        // a zero vector and a singular system
+        va[1] = vector3f(0.0f, 0.0f, 0.0f);
+        a.set(2, matrix44<float>());
+
+        v0 = vector_stream<float, 3>(va.begin(), va.end());
+        v1 = vector_stream<float, 3>(vb.begin(), vb.end());
+        q0 = quaternion_stream<float>(qa.begin(), qa.end());
+        q1 = quaternion_stream<float>(qb.begin(), qb.end());
+    }
+
+    vector_stream<float, 3> v0;
+    vector_stream<float, 3> v1;
+    quaternion_stream<float> q0;
+    quaternion_stream<float> q1;
+    std::vector<float> t;
+    matrix_batch<float, 4, 4> a;
+    matrix_batch<float, 4, 1> b;
+    matrix_batch<float, 3, 3> symmetric;
+    matrix_batch<float, 3, 3> a3;
+};
+
+// every kernel of k against the same kernel of exp_k
+void check_kernels(batch_kernels<float> const& k, batch_kernels<float> const& exp_k)
+{
+    kernel_inputs in;
+
+    std::vector<float> d(in.v0.stride());
+    std::vector<float> exp_d(in.v0.stride());
+    k.dot(in.v0, in.v1, d.data());
+    exp_k.dot(in.v0, in.v1, exp_d.data());
+    check_approx(d.data(), exp_d.data(), batch_size, 1e-6f);
+
+    vector_stream<float, 3> v;
+    vector_stream<float, 3> exp_v;
+    k.cross(in.v0, in.v1, v);
+    exp_k.cross(in.v0, in.v1, exp_v);
+    check_approx(v, exp_v, 1e-6f);
+
+    bool ok[batch_size];
+    bool exp_ok[batch_size];
+    BOOST_CHECK(!k.normalize(in.v0, v, ok, 1e-6f));
+    BOOST_CHECK(!exp_k.normalize(in.v0, exp_v, exp_ok, 1e-6f));
+    KISMET_CHECK_EQUAL_COLLECTIONS(ok, exp_ok);
+    check_approx(v, exp_v, 1e-6f);
+
+    k.rotate(in.q0, in.v0, v);
+    exp_k.rotate(in.q0, in.v0, exp_v);
+    check_approx(v, exp_v, 1e-5f);
+
+    quaternion_stream<float> q;
+    quaternion_stream<float> exp_q;
+    k.multiply(in.q0, in.q1, q);
+    exp_k.multiply(in.q0, in.q1, exp_q);
+    check_approx(q, exp_q, 1e-6f);
+
+    k.slerp(in.q0, in.q1, in.t.data(), q);
+    exp_k.slerp(in.q0, in.q1, in.t.data(), exp_q);
+    check_approx(q, exp_q, 1e-6f);
+
+    k.quat_from_euler_yxz(in.v0, q);
+    exp_k.quat_from_euler_yxz(in.v0, exp_q);
+    check_approx(q, exp_q, 1e-6f);
+
+    matrix_batch<float, 4, 4> m;
+    matrix_batch<float, 4, 4> exp_m;
+    k.matrix_rotate(in.q0, m);
+    exp_k.matrix_rotate(in.q0, exp_m);
+    check_approx(m, exp_m, 1e-6f);
+
+    k.matrix_to_quat(m, q);
+    exp_k.matrix_to_quat(m, exp_q);
+    check_approx(q, exp_q, 1e-5f);
+
+    matrix_batch<float, 4, 1> x;
+    matrix_batch<float, 4, 1> exp_x;
+    BOOST_CHECK(!k.solve_partial_pivoting(in.a, in.b, x, ok, 1e-6f));
+    BOOST_CHECK(!exp_k.solve_partial_pivoting(in.a, in.b, exp_x, exp_ok, 1e-6f));
+    KISMET_CHECK_EQUAL_COLLECTIONS(ok, exp_ok);
+    BOOST_CHECK(!ok[2]);
+    for (std::size_t n = 0; n < batch_size; ++n)
+    {
+        if (n != 2)
+        {
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                BOOST_CHECK(approx(x.element(i, 0)[n], exp_x.element(i, 0)[n], 1e-5f));
+            }
+        }
+    }
+
+    matrix_batch<float, 3, 3> vectors;
+    matrix_batch<float, 3, 3> exp_vectors;
+    k.eigen_decompose_symmetric(in.symmetric, v, vectors);
+    exp_k.eigen_decompose_symmetric(in.symmetric, exp_v, exp_vectors);
+    check_approx(v, exp_v, 1e-5f);
+    check_approx(vectors, exp_vectors, 1e-4f);
+
+    matrix_batch<float, 3, 3> u;
+    matrix_batch<float, 3, 3> exp_u;
+    k.svd_decompose(in.a3, u, v, vectors);
+    exp_k.svd_decompose(in.a3, exp_u, exp_v, exp_vectors);
+    check_approx(u, exp_u, 1e-4f);
+    check_approx(v, exp_v, 1e-5f);
+    check_approx(vectors, exp_vectors, 1e-4f);
+
+    k.polar_decompose(in.a3, u, vectors);
+    exp_k.polar_decompose(in.a3, exp_u, exp_vectors);
+    check_approx(u, exp_u, 1e-4f);
+    check_approx(vectors, exp_vectors, 1e-4f);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(batch_kernels_test)
+
+BOOST_AUTO_TEST_CASE(simd_level_override)
+{
+    simd_level level = simd_level::scalar;
+    BOOST_CHECK(parse_simd_level("avx2", level));
+    BOOST_CHECK(level == simd_level::avx2);
+    BOOST_CHECK(!parse_simd_level("neon", level));
+    BOOST_CHECK(!parse_simd_level(nullptr, level));
+
+    BOOST_CHECK(override_simd_level(simd_level::avx2, "scalar") == simd_level::scalar);
+    BOOST_CHECK(override_simd_level(simd_level::avx2, "sse2") == simd_level::sse2);
+    // never above the detected level
+    BOOST_CHECK(override_simd_level(simd_level::sse2, "avx512") == simd_level::sse2);
+    BOOST_CHECK(override_simd_level(simd_level::avx2, "fast") == simd_level::avx2);
+    BOOST_CHECK(override_simd_level(simd_level::avx2, nullptr) == simd_level::avx2);
+
+    BOOST_CHECK(active_simd_level() <= detect_simd_level());
+    for (simd_level l : all_levels)
+    {
+        BOOST_CHECK_EQUAL(simd_level_name(l), simd_level_name(override_simd_level(l, simd_level_name(l))));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_kernels_selection)
+{
+    BOOST_REQUIRE(find_batch_kernels<float>(simd_level::scalar) != nullptr);
+    BOOST_REQUIRE(find_batch_kernels<double>(simd_level::scalar) != nullptr);
+
+    batch_kernels<float> const& k = get_batch_kernels<float>();
+    BOOST_CHECK(k.level <= active_simd_level());
+    BOOST_CHECK(&k == find_batch_kernels<float>(k.level));
+    BOOST_CHECK(get_batch_kernels<double>().level == k.level);
+    BOOST_TEST_MESSAGE("batch kernels: " << simd_level_name(k.level));
+}
+
+BOOST_AUTO_TEST_CASE(batch_kernels_levels)
+{
+    batch_kernels<float> const& scalar = *find_batch_kernels<float>(simd_level::scalar);
+    for (simd_level l : all_levels)
+    {
+        if (batch_kernels<float> const* k = find_batch_kernels<float>(l))
+        {
+            BOOST_TEST_CONTEXT("level " << simd_level_name(l))
+            {
+                BOOST_CHECK(k->level == l);
+                check_kernels(*k, scalar);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_kernels_double)
+{
+    // spot check of the double table against the templates
+    std::vector<vector3d> va = { vector3d(1.0, 2.0, 3.0), vector3d(-4.0, 0.5, 2.0), vector3d(0.0, 0.0, 0.0) };
+    std::vector<vector3d> vb = { vector3d(2.0, -1.0, 0.5), vector3d(1.0, 1.0, 1.0), vector3d(3.0, 2.0, 1.0) };
+    vector_stream<double, 3> a(va.begin(), va.end());
+    vector_stream<double, 3> b(vb.begin(), vb.end());
+    for (simd_level l : all_levels)
+    {
+        if (batch_kernels<double> const* k = find_batch_kernels<double>(l))
+        {
+            std::vector<double> d(a.stride());
+            k->dot(a, b, d.data());
+            vector_stream<double, 3> c;
+            k->cross(a, b, c);
+            for (std::size_t n = 0; n < va.size(); ++n)
+            {
+                BOOST_CHECK(approx(d[n], dot(va[n], vb[n]), 1e-12));
+                KISMET_CHECK_APPROX_COLLECTIONS(c.get(n), cross(va[n], vb[n]));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
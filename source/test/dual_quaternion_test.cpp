@@ -0,0 +1,164 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/dual_quaternion.h"
+#include "kismet/math/transform.h"
+#include "kismet/math/vector_stream.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+dual_quaternionf random_transform(std::mt19937& mt)
+{
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    quaternionf q(dis(mt), dis(mt), dis(mt), dis(mt));
+    q.normalize();
+    return dual_quaternionf(q, vector3f(dis(mt), dis(mt), dis(mt)) * 5.0f);
+}
+
+void check_approx(vector3f const& v, vector3f const& exp_v)
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(approx(v[i], exp_v[i], 1e-5f));
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(dual_quaternion_test)
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_rotation_translation)
+{
+    vector3f axis(1.0f, -2.0f, 0.5f);
+    axis.normalize();
+    quaternionf q(axis, 0.8f);
+    vector3f t(1.5f, -2.0f, 3.0f);
+
+    dual_quaternionf dq(q, t);
+    KISMET_CHECK_APPROX_COLLECTIONS(dq.rotation(), q);
+    check_approx(dq.translation(), t);
+
+    vector3f v(0.3f, 4.0f, -1.0f);
+    check_approx(dq * v, q * v + t);
+    check_approx(transform_vector(dq, v), q * v);
+
+    matrix44<float> m = dual_quat_to_matrix(dq);
+    vector4f mv = m * vector4f(v.x(), v.y(), v.z(), 1.0f);
+    check_approx(vector3f(mv.x(), mv.y(), mv.z()), q * v + t);
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_compose)
+{
+    std::mt19937 mt;
+    dual_quaternionf a = random_transform(mt);
+    dual_quaternionf b = random_transform(mt);
+    vector3f v(0.3f, 4.0f, -1.0f);
+
+    // b is applied first
+    check_approx((a * b) * v, a * (b * v));
+
+    // the conjugate is the inverse
+    check_approx(conjugate(a) * (a * v), v);
+
+    dual_quaternionf ab = a * b;
+    ab *= 3.0f;
+    BOOST_CHECK(ab.normalize());
+    check_approx(ab * v, a * (b * v));
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_blend)
+{
+    std::mt19937 mt;
+    dual_quaternionf a = random_transform(mt);
+    dual_quaternionf b = random_transform(mt);
+    vector3f v(0.3f, 4.0f, -1.0f);
+
+    check_approx(blend(a, b, 0.0f) * v, a * v);
+    check_approx(blend(a, b, 1.0f) * v, b * v);
+
+    // the sign of a dual quaternion does not matter
+    dual_quaternionf neg_a = -1.0f * a;
+    check_approx(blend(a, neg_a, 0.5f) * v, a * v);
+
+    // translations blend linearly if the rotations are the same
+    dual_quaternionf c(a.rotation(), a.translation() + vector3f(2.0f, 0.0f, 0.0f));
+    check_approx(blend(a, c, 0.25f).translation(), a.translation() + vector3f(0.5f, 0.0f, 0.0f));
+
+    float zero[] = { 0.0f, 0.0f };
+    dual_quaternionf dq[] = { a, b };
+    BOOST_CHECK(blend(dq, zero, 2) == dual_quaternionf::identity);
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_skin)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    std::uniform_int_distribution<std::size_t> joint(0, 9);
+
+    std::vector<dual_quaternionf> palette(10);
+    for (auto& dq : palette)
+    {
+        dq = random_transform(mt);
+    }
+    // opposite hemisphere
+    palette[1] = -1.0f * palette[1];
+
+    // not a multiple of the SIMD lanes
+    const std::size_t n = 37;
+    const std::size_t influences = 4;
+    std::vector<vector3f> positions(n);
+    std::vector<vector3f> normals(n);
+    std::vector<std::size_t> joints(n * influences);
+    std::vector<float> weights(n * influences);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        positions[k] = vector3f(dis(mt), dis(mt), dis(mt));
+        normals[k] = vector3f(dis(mt), dis(mt), dis(mt));
+        float sum = 0.0f;
+        for (std::size_t i = 0; i < influences; ++i)
+        {
+            joints[k * influences + i] = joint(mt);
+            weights[k * influences + i] = dis(mt) + 1.0f;
+            sum += weights[k * influences + i];
+        }
+        for (std::size_t i = 0; i < influences; ++i)
+        {
+            weights[k * influences + i] /= sum;
+        }
+    }
+    joints[0] = 0;
+    joints[1] = 1;
+
+    vector_stream<float, 3> sp(positions.begin(), positions.end());
+    vector_stream<float, 3> sn(normals.begin(), normals.end());
+    vector_stream<float, 3> out_p;
+    vector_stream<float, 3> out_n;
+    skin(palette.data(), influences, joints.data(), weights.data(), sp, sn, out_p, out_n);
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        std::vector<dual_quaternionf> dq(influences);
+        for (std::size_t i = 0; i < influences; ++i)
+        {
+            dq[i] = palette[joints[k * influences + i]];
+        }
+        dual_quaternionf b = blend(dq.data(), weights.data() + k * influences, influences);
+        check_approx(out_p.get(k), b * positions[k]);
+        check_approx(out_n.get(k), transform_vector(b, normals[k]));
+    }
+
+    // in place, positions only
+    skin(palette.data(), influences, joints.data(), weights.data(), sp, sp);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        check_approx(sp.get(k), out_p.get(k));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
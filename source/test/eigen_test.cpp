@@ -0,0 +1,235 @@
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/eigen.h"
+#include "kismet/math/transform.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t batch_size = 37;
+
+// R*diag(l)*R^T
+template<typename T>
+matrix<T, 3, 3> compose(vector3<T> const& l, matrix<T, 3, 3> const& r)
+{
+    matrix<T, 3, 3> a{};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                a[i][j] += r[i][k] * l[k] * r[j][k];
+            }
+        }
+    }
+    return a;
+}
+
+template<typename T>
+matrix<T, 3, 3> random_rotation(std::mt19937& mt)
+{
+    std::uniform_real_distribution<T> dis(T(-1), T(1));
+    quaternion<T> q(dis(mt), dis(mt), dis(mt), dis(mt));
+    q.normalize();
+    matrix44<T> m = matrix_rotate(q);
+    matrix<T, 3, 3> r;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            r[i][j] = m[i][j];
+        }
+    }
+    return r;
+}
+
+// A = V*diag(values)*V^T, V is a rotation and the values ascend
+template<typename T>
+void check_decomposition(matrix<T, 3, 3> const& a, vector3<T> const& values,
+                         matrix<T, 3, 3> const& v, T tolerance)
+{
+    BOOST_CHECK(values[0] <= values[1] && values[1] <= values[2]);
+
+    matrix<T, 3, 3> exp_a = compose(values, v);
+    matrix<T, 3, 3> vtv = transpose(v) * v;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            BOOST_CHECK(approx(exp_a[i][j], a[i][j], tolerance));
+            BOOST_CHECK(approx(vtv[i][j], i == j ? T(1) : T(0), tolerance));
+        }
+    }
+    T det = v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1])
+          - v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0])
+          + v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+    BOOST_CHECK(approx(det, T(1), tolerance));
+}
+
+template<typename T>
+void check_random(T tolerance)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<T> dis(T(-10), T(10));
+    for (std::size_t k = 0; k < 100; ++k)
+    {
+        vector3<T> exp_l(dis(mt), dis(mt), dis(mt));
+        matrix<T, 3, 3> a = compose(exp_l, random_rotation<T>(mt));
+        std::sort(exp_l.begin(), exp_l.end());
+
+        vector3<T> l;
+        matrix<T, 3, 3> v;
+        BOOST_CHECK(eigen_decompose_symmetric(a, l, v));
+        check_decomposition(a, l, v, tolerance);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            BOOST_CHECK(approx(l[i], exp_l[i], tolerance));
+        }
+
+        BOOST_CHECK(eigen_decompose_jacobi(a, l, v));
+        check_decomposition(a, l, v, tolerance);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(eigen_test)
+
+BOOST_AUTO_TEST_CASE(eigen_random)
+{
+    check_random<float>(1e-4f);
+    check_random<double>(1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(eigen_special)
+{
+    vector3<double> l;
+    matrix<double, 3, 3> v;
+
+    // diagonal
+    matrix<double, 3, 3> diagonal{ { 3.0, 0.0, 0.0 }, { 0.0, -1.0, 0.0 }, { 0.0, 0.0, 2.0 } };
+    BOOST_CHECK(eigen_decompose_symmetric(diagonal, l, v));
+    check_decomposition(diagonal, l, v, 1e-12);
+    BOOST_CHECK_EQUAL(l[0], -1.0);
+    BOOST_CHECK_EQUAL(l[1], 2.0);
+    BOOST_CHECK_EQUAL(l[2], 3.0);
+
+    // a multiple of I
+    matrix<double, 3, 3> scalar{ { 2.0, 0.0, 0.0 }, { 0.0, 2.0, 0.0 }, { 0.0, 0.0, 2.0 } };
+    BOOST_CHECK(eigen_decompose_symmetric(scalar, l, v));
+    check_decomposition(scalar, l, v, 1e-12);
+
+    matrix<double, 3, 3> zero{};
+    BOOST_CHECK(eigen_decompose_symmetric(zero, l, v));
+    check_decomposition(zero, l, v, 1e-12);
+
+    // repeated and nearly repeated eigenvalues, where the closed form falls back
+    std::mt19937 mt;
+    const vector3<double> repeated[] = {
+        vector3<double>(1.0, 1.0, 5.0),
+        vector3<double>(-2.0, 4.0, 4.0),
+        vector3<double>(1.0, 1.0 + 1e-9, 1.0 + 2e-9),
+        vector3<double>(1e-8, 1.0, 1e8)
+    };
+    for (auto const& exp_l : repeated)
+    {
+        matrix<double, 3, 3> a = compose(exp_l, random_rotation<double>(mt));
+        BOOST_CHECK(eigen_decompose_symmetric(a, l, v));
+        check_decomposition(a, l, v, 1e-12 * exp_l[2]);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            BOOST_CHECK(approx(l[i], exp_l[i], 1e-12 * exp_l[2]));
+        }
+    }
+
+    // an inertia tensor of a box along the rotated axes
+    matrix<double, 3, 3> r = random_rotation<double>(mt);
+    matrix<double, 3, 3> inertia = compose(vector3<double>(5.0, 13.0, 10.0), r);
+    quaternion<double> q;
+    BOOST_CHECK(eigen_decompose_symmetric(inertia, l, q));
+    matrix44<double> m = matrix_rotate(q);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            v[i][j] = m[i][j];
+        }
+    }
+    check_decomposition(inertia, l, v, 1e-12);
+
+    matrix<double, 3, 3> nan{ { std::nan(""), 0.0, 0.0 }, { 1.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    BOOST_CHECK(!eigen_decompose_symmetric(nan, l, v));
+}
+
+BOOST_AUTO_TEST_CASE(eigen_batch)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<float> dis(-10.0f, 10.0f);
+    matrix_batch<float, 3, 3> a(batch_size);
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        vector3<float> l(dis(mt), dis(mt), dis(mt));
+        if (k % 4 == 1)
+        {
+            l[1] = l[0];
+        }
+        else if (k % 4 == 2)
+        {
+            l = vector3<float>(1.0f, 1.0f, 1.0f);
+        }
+        a.set(k, compose(l, random_rotation<float>(mt)));
+    }
+
+    vector_stream<float, 3> values;
+    matrix_batch<float, 3, 3> vectors;
+    eigen_decompose_symmetric(a, values, vectors);
+    BOOST_REQUIRE_EQUAL(values.size(), batch_size);
+    BOOST_REQUIRE_EQUAL(vectors.size(), batch_size);
+
+    quaternion_stream<float> q;
+    eigen_decompose_symmetric(a, values, q);
+    BOOST_REQUIRE_EQUAL(q.size(), batch_size);
+
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        check_decomposition(a.get(k), values.get(k), vectors.get(k), 1e-4f);
+
+        // the same rotation as the matrix
+        matrix44<float> m = matrix_rotate(q.get(k));
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                BOOST_CHECK(approx(m[i][j], vectors.get(k)[i][j], 1e-5f));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(eigen_batch_keeps_zero_padding)
+{
+    // the zero padding has identity eigenvectors
+    matrix_batch<float, 3, 3> a(3);
+    a.set(0, compose(vector3<float>(1.0f, 2.0f, 3.0f), matrix<float, 3, 3>(matrix<float, 3, 3>::identity)));
+
+    vector_stream<float, 3> values;
+    matrix_batch<float, 3, 3> vectors;
+    eigen_decompose_symmetric(a, values, vectors);
+    kismet::test::check_zero_padding(values);
+    kismet::test::check_zero_padding(vectors);
+
+    quaternion_stream<float> q;
+    eigen_decompose_symmetric(a, values, q);
+    kismet::test::check_zero_padding(q);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/ai/fuzzy/fuzzy_batch.h"
+#include "kismet/ai/fuzzy/fuzzy_set_trapezoid.h"
+#include "kismet/ai/fuzzy/fuzzy_set_triangle.h"
+#include "kismet/math/math_trait.h"
+
+using namespace kismet;
+using namespace kismet::fuzzy;
+
+namespace
+{
+
+const simd_level all_levels[] = { simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512 };
+
+// inputs around and on the corners
+std::vector<float> inputs(float m1, float m4)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<float> dis(m1 - 1.0f, m4 + 1.0f);
+    std::vector<float> x(37);
+    for (auto& e : x)
+    {
+        e = dis(mt);
+    }
+    return x;
+}
+
+void check_kernel(dom_trapezoid_kernel kernel, fuzzy_set const& set, float m1, float m2, float m3, float m4)
+{
+    std::vector<float> x = inputs(m1, m4);
+    x[0] = m1;
+    x[1] = m2;
+    x[2] = m3;
+    x[3] = m4;
+
+    std::vector<float> dom(x.size());
+    kernel(m1, m2, m3, m4, x.data(), dom.data(), x.size());
+    for (std::size_t k = 0; k < x.size(); ++k)
+    {
+        BOOST_CHECK(math::approx(dom[k], set.get_dom(x[k]), 1e-6f));
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(fuzzy_batch_test)
+
+BOOST_AUTO_TEST_CASE(fuzzy_batch_trapezoid)
+{
+    fuzzy_set_trapezoid trapezoid(1.0f, 2.0f, 4.0f, 6.0f);
+    fuzzy_set_trapezoid rectangle(1.0f, 1.0f, 4.0f, 4.0f);
+    fuzzy_set_triangle triangle(-1.0f, 0.5f, 3.0f);
+    fuzzy_set_triangle right_angle(-1.0f, -1.0f, 3.0f);
+
+    for (simd_level l : all_levels)
+    {
+        if (dom_trapezoid_kernel kernel = find_dom_trapezoid_kernel(l))
+        {
+            BOOST_TEST_CONTEXT("level " << simd_level_name(l))
+            {
+                check_kernel(kernel, trapezoid, 1.0f, 2.0f, 4.0f, 6.0f);
+                check_kernel(kernel, rectangle, 1.0f, 1.0f, 4.0f, 4.0f);
+                check_kernel(kernel, triangle, -1.0f, 0.5f, 0.5f, 3.0f);
+                check_kernel(kernel, right_angle, -1.0f, -1.0f, -1.0f, 3.0f);
+            }
+        }
+    }
+    BOOST_CHECK(find_dom_trapezoid_kernel(simd_level::scalar) != nullptr);
+
+    float x[] = { 0.0f, 1.5f, 3.0f, 5.0f, 7.0f };
+    float dom[5];
+    get_dom_trapezoid(1.0f, 2.0f, 4.0f, 6.0f, x, dom, 5);
+    float exp_dom[] = { 0.0f, 0.5f, 1.0f, 0.5f, 0.0f };
+    BOOST_CHECK_EQUAL_COLLECTIONS(dom, dom + 5, exp_dom, exp_dom + 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
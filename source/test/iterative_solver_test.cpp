@@ -0,0 +1,250 @@
+#include <cstddef>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "kismet/math/iterative_solver.h"
+#include "kismet/math/linear_system.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/sparse_matrix.h"
+
+using namespace std;
+using namespace kismet::math;
+
+namespace
+{
+
+// 1D Laplacian, tridiagonal with 2 on the diagonal and -1 next to it
+template<size_t N>
+struct laplacian_operator
+{
+    size_t size() const
+    {
+        return N;
+    }
+
+    void apply(double const* x, double* y) const
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            y[i] = row_dot(i, x);
+        }
+    }
+
+    double diagonal(size_t) const
+    {
+        return 2;
+    }
+
+    double row_dot(size_t i, double const* x) const
+    {
+        double s = 2 * x[i];
+        if (i > 0)
+        {
+            s -= x[i - 1];
+        }
+        if (i + 1 < N)
+        {
+            s -= x[i + 1];
+        }
+        return s;
+    }
+};
+
+template<size_t N>
+void check_approx(matrix<double, N, 1> const& x, matrix<double, N, 1> const& exp_x)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        BOOST_CHECK(approx(x.data()[i], exp_x.data()[i], 1e-8));
+    }
+}
+
+matrix<double, 4, 4> const diagonally_dominant
+{
+    { 10, -1, 2, 0 },
+    { -1, 11, -1, 3 },
+    { 2, -1, 10, -1 },
+    { 0, 3, -1, 8 }
+};
+
+matrix<double, 4, 1> const diagonally_dominant_b{ { 6 }, { 25 }, { -11 }, { 15 } };
+matrix<double, 4, 1> const diagonally_dominant_x{ { 1 }, { 2 }, { -1 }, { 1 } };
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(iterative_solver_test)
+
+BOOST_AUTO_TEST_CASE(iterative_solver_conjugate_gradient)
+{
+    matrix<double, 3, 3> a
+    {
+        { 4, 12, -16 },
+        { 12, 37, -43 },
+        { -16, -43, 98 }
+    };
+    matrix<double, 3, 1> b{ { 0 }, { 6 }, { 39 } };
+    matrix<double, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+
+    matrix<double, 3, 1> x{ { 0 }, { 0 }, { 0 } };
+    iterative_solve_info<double> info;
+    BOOST_CHECK(conjugate_gradient(a, b, x, 10, &info, 1e-9));
+    check_approx(x, exp_x);
+    // converges in at most N iterations in exact arithmetic
+    BOOST_CHECK(info.iterations <= 4);
+    BOOST_CHECK(info.residual <= 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(iterative_solver_warm_start)
+{
+    matrix<double, 4, 1> x(diagonally_dominant_x);
+    iterative_solve_info<double> info;
+
+    BOOST_CHECK(conjugate_gradient(diagonally_dominant, diagonally_dominant_b, x, 10, &info, 1e-9));
+    BOOST_CHECK_EQUAL(info.iterations, 0u);
+
+    BOOST_CHECK(jacobi(diagonally_dominant, diagonally_dominant_b, x, 10, &info, 1e-9));
+    BOOST_CHECK_EQUAL(info.iterations, 0u);
+
+    BOOST_CHECK(gauss_seidel(diagonally_dominant, diagonally_dominant_b, x, 10, &info, 1e-9));
+    BOOST_CHECK_EQUAL(info.iterations, 0u);
+    check_approx(x, diagonally_dominant_x);
+}
+
+BOOST_AUTO_TEST_CASE(iterative_solver_jacobi_gauss_seidel)
+{
+    matrix<double, 4, 1> x{ { 0 }, { 0 }, { 0 }, { 0 } };
+    iterative_solve_info<double> jacobi_info;
+    BOOST_CHECK(jacobi(diagonally_dominant, diagonally_dominant_b, x, 100, &jacobi_info, 1e-9));
+    check_approx(x, diagonally_dominant_x);
+    BOOST_CHECK(jacobi_info.residual <= 1e-9);
+
+    // the reported iterations are the fewest which converge
+    x = matrix<double, 4, 1>{ { 0 }, { 0 }, { 0 }, { 0 } };
+    iterative_solve_info<double> info;
+    BOOST_CHECK(!jacobi(diagonally_dominant, diagonally_dominant_b, x, jacobi_info.iterations - 1, &info, 1e-9));
+    BOOST_CHECK_EQUAL(info.iterations, jacobi_info.iterations - 1);
+    BOOST_CHECK(info.residual > 1e-9);
+
+    x = matrix<double, 4, 1>{ { 0 }, { 0 }, { 0 }, { 0 } };
+    iterative_solve_info<double> gs_info;
+    BOOST_CHECK(gauss_seidel(diagonally_dominant, diagonally_dominant_b, x, 100, &gs_info, 1e-9));
+    check_approx(x, diagonally_dominant_x);
+    BOOST_CHECK(gs_info.residual <= 1e-9);
+
+    // Gauss-Seidel uses the updated values right away
+    BOOST_CHECK(gs_info.iterations < jacobi_info.iterations);
+
+    // not enough iterations
+    x = matrix<double, 4, 1>{ { 0 }, { 0 }, { 0 }, { 0 } };
+    BOOST_CHECK(!gauss_seidel(diagonally_dominant, diagonally_dominant_b, x, 2, &gs_info, 1e-9));
+    BOOST_CHECK_EQUAL(gs_info.iterations, 2u);
+    BOOST_CHECK(gs_info.residual > 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(iterative_solver_zero_diagonal_fail)
+{
+    matrix<double, 2, 2> a
+    {
+        { 0, 1 },
+        { 1, 0 }
+    };
+    matrix<double, 2, 1> b{ { 1 }, { 1 } };
+    matrix<double, 2, 1> x{ { 0 }, { 0 } };
+
+    BOOST_CHECK(!jacobi(a, b, x, 10));
+    BOOST_CHECK(!gauss_seidel(a, b, x, 10));
+}
+
+BOOST_AUTO_TEST_CASE(iterative_solver_matrix_free)
+{
+    const size_t n = 16;
+    laplacian_operator<n> op;
+
+    matrix<double, n, 1> b;
+    for (size_t i = 0; i < n; ++i)
+    {
+        b[i] = 1;
+    }
+
+    matrix<double, n, n> a;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            a[i][j] = i == j ? 2 : (i == j + 1 || j == i + 1 ? -1 : 0);
+        }
+    }
+    matrix<double, n, 1> exp_x;
+    BOOST_REQUIRE(solve_partial_pivoting(a, b, exp_x));
+
+    matrix<double, n, 1> x;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = 0;
+    }
+    iterative_solve_info<double> info;
+    BOOST_CHECK(conjugate_gradient(op, b, x, n + 4, &info, 1e-9));
+    check_approx(x, exp_x);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = 0;
+    }
+    BOOST_CHECK(gauss_seidel(op, b, x, 5000, &info, 1e-9));
+    check_approx(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(iterative_solver_sparse)
+{
+    // 1D Laplacian of a size only known at run time
+    const size_t n = 200;
+    std::vector<triplet<double>> entries;
+    for (size_t i = 0; i < n; ++i)
+    {
+        entries.push_back({ i, i, 2 });
+        if (i > 0)
+        {
+            entries.push_back({ i, i - 1, -1 });
+        }
+        if (i + 1 < n)
+        {
+            entries.push_back({ i, i + 1, -1 });
+        }
+    }
+    csr_matrix<double> a(n, n, entries.begin(), entries.end());
+
+    // the solution of A*x = b with b[i] = 1 is x[i] = (i + 1)*(n - i)/2
+    std::vector<double> b(n, 1);
+    std::vector<double> x(n, 0);
+    iterative_solve_info<double> info;
+    BOOST_CHECK(conjugate_gradient(csr_operator<double>(a), b.data(), x.data(), n + 20, &info, 1e-9));
+    BOOST_CHECK(info.residual <= 1e-9);
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK(approx(x[i], (i + 1) * (n - i) / 2.0, 1e-6));
+    }
+
+    // the same system in 2x2 blocks
+    std::vector<block_triplet<double, 2>> blocks;
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+        blocks.push_back({ i, i, matrix<double, 2, 2>{ { 2, -1 }, { -1, 2 } } });
+        if (i > 0)
+        {
+            blocks.push_back({ i, i - 1, matrix<double, 2, 2>{ { 0, -1 }, { 0, 0 } } });
+        }
+        if (i + 1 < n / 2)
+        {
+            blocks.push_back({ i, i + 1, matrix<double, 2, 2>{ { 0, 0 }, { -1, 0 } } });
+        }
+    }
+    bsr_matrix<double, 2> block_a(n / 2, n / 2, blocks.begin(), blocks.end());
+
+    std::vector<double> y(n, 0);
+    BOOST_CHECK(conjugate_gradient(bsr_operator<double, 2>(block_a), b.data(), y.data(), n + 20, &info, 1e-9));
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK(approx(y[i], x[i], 1e-6));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
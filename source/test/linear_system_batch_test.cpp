@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/linear_system.h"
+#include "kismet/math/linear_system_batch.h"
+#include "kismet/math/matrix.h"
+#include "kismet/math/matrix_batch.h"
+#include "test/utility.h"
+
+using namespace std;
+using namespace kismet::math;
+
+namespace
+{
+
+template<typename T, size_t N1, size_t N2>
+void random_batch(matrix_batch<T, N1, N2>& batch, mt19937& mt)
+{
+    uniform_real_distribution<T> dis(T(-1), T(1));
+    for (size_t i = 0; i < N1; ++i)
+    {
+        for (size_t j = 0; j < N2; ++j)
+        {
+            generate_n(batch.element(i, j), batch.size(), [&] { return dis(mt); });
+        }
+    }
+}
+
+template<typename T, size_t N>
+void check_approx(matrix<T, N, 1> const& x, matrix<T, N, 1> const& exp_x, T tol)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        BOOST_CHECK(approx(x.data()[i], exp_x.data()[i], tol));
+    }
+}
+
+template<typename T, size_t N>
+void random_spd_batch(matrix_batch<T, N, N>& batch, mt19937& mt)
+{
+    matrix_batch<T, N, N> m(batch.size());
+    random_batch(m, mt);
+    for (size_t k = 0; k < batch.size(); ++k)
+    {
+        batch.set(k, m.get(k) * transpose(m.get(k)) + matrix<T, N, N>::identity);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(linear_system_batch_test)
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_solve2x2)
+{
+    matrix_batch<float, 2, 2> a(2);
+    matrix_batch<float, 2, 1> b(2);
+    a.set(0, matrix22f{ { 1, 0 }, { 2, 1 } });
+    b.set(0, matrix<float, 2, 1>{ { 1 }, { 2 } });
+    // singular
+    a.set(1, matrix22f{ { 1, 2 }, { 1, 2 } });
+    b.set(1, matrix<float, 2, 1>{ { 1 }, { 2 } });
+
+    matrix_batch<float, 2, 1> x;
+    bool ok[2];
+    BOOST_CHECK(!solve(a, b, x, ok));
+    BOOST_CHECK(ok[0]);
+    BOOST_CHECK(!ok[1]);
+
+    matrix<float, 2, 1> exp_x{ { 1 }, { 0 } };
+    KISMET_CHECK_APPROX_COLLECTIONS(x.get(0), exp_x);
+    KISMET_CHECK_EQUAL_COLLECTIONS(x.get(1), (matrix<float, 2, 1>{ { 0 }, { 0 } }));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_solve3x3_matches_single)
+{
+    mt19937 mt;
+    matrix_batch<double, 3, 3> a(45);
+    matrix_batch<double, 3, 1> b(45);
+    random_batch(a, mt);
+    random_batch(b, mt);
+
+    matrix_batch<double, 3, 1> x;
+    BOOST_CHECK(solve(a, b, x));
+
+    for (size_t k = 0; k < a.size(); ++k)
+    {
+        matrix<double, 3, 1> exp_x;
+        BOOST_REQUIRE(solve_partial_pivoting(a.get(k), b.get(k), exp_x));
+        check_approx(x.get(k), exp_x, 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_solve_partial_pivoting_matches_single)
+{
+    mt19937 mt;
+    matrix_batch<double, 6, 6> a(70);
+    matrix_batch<double, 6, 1> b(70);
+    random_batch(a, mt);
+    random_batch(b, mt);
+
+    // make a system singular
+    matrix<double, 6, 6> singular = a.get(40);
+    singular[5] = singular[2];
+    a.set(40, singular);
+
+    matrix_batch<double, 6, 1> x;
+    bool ok[70];
+    BOOST_CHECK(!solve_partial_pivoting(a, b, x, ok, 1e-12));
+
+    for (size_t k = 0; k < a.size(); ++k)
+    {
+        matrix<double, 6, 1> exp_x;
+        bool exp_ok = solve_partial_pivoting(a.get(k), b.get(k), exp_x, 1e-12);
+        BOOST_CHECK_EQUAL(ok[k], exp_ok);
+        if (exp_ok)
+        {
+            check_approx(x.get(k), exp_x, 1e-9);
+        }
+    }
+    BOOST_CHECK(!ok[40]);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_invert)
+{
+    mt19937 mt;
+    matrix_batch<double, 4, 4> a(33);
+    random_batch(a, mt);
+
+    matrix_batch<double, 4, 4> inverse;
+    BOOST_CHECK(invert(a, inverse));
+
+    for (size_t k = 0; k < a.size(); ++k)
+    {
+        auto identity = a.get(k) * inverse.get(k);
+        for (size_t i = 0; i < identity.size(); ++i)
+        {
+            BOOST_CHECK(approx(identity.data()[i], matrix<double, 4, 4>::identity.data()[i], 1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_invert3x3)
+{
+    matrix_batch<float, 3, 3> a(2);
+    a.set(0, matrix33f
+    {
+        { 1, 2, 4 },
+        { 2, 2, 4 },
+        { 4, 4, 4 }
+    });
+
+    matrix33f exp_inv
+    {
+        { -1, 1, 0 },
+        { 1, -1.5f, 0.5f },
+        { 0, 0.5f, -0.25f }
+    };
+
+    matrix_batch<float, 3, 3> inverse;
+    bool ok[2];
+    BOOST_CHECK(!invert(a, inverse, ok));
+    BOOST_CHECK(ok[0]);
+    BOOST_CHECK(!ok[1]);
+    KISMET_CHECK_APPROX_COLLECTIONS(inverse.get(0), exp_inv);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_cholesky_matches_single)
+{
+    mt19937 mt;
+    matrix_batch<double, 6, 6> a(40);
+    matrix_batch<double, 6, 1> b(40);
+    random_spd_batch(a, mt);
+    random_batch(b, mt);
+
+    // not positive definite
+    a.set(7, -1.0 * a.get(7));
+
+    matrix_batch<double, 6, 6> l;
+    bool ok[40];
+    BOOST_CHECK(!cholesky_decompose(a, l, ok));
+    BOOST_CHECK(!ok[7]);
+
+    matrix_batch<double, 6, 1> x;
+    cholesky_solve(l, b, x);
+
+    matrix_batch<double, 6, 1> x2;
+    bool ok2[40];
+    BOOST_CHECK(!solve_cholesky(a, b, x2, ok2));
+
+    for (size_t k = 0; k < a.size(); ++k)
+    {
+        BOOST_CHECK_EQUAL(ok[k], ok2[k]);
+        if (k == 7)
+        {
+            continue;
+        }
+
+        BOOST_CHECK(ok[k]);
+
+        matrix<double, 6, 6> exp_l;
+        BOOST_REQUIRE(cholesky_decompose(a.get(k), exp_l));
+        KISMET_CHECK_APPROX_COLLECTIONS(l.get(k), exp_l);
+
+        matrix<double, 6, 1> exp_x;
+        cholesky_solve(exp_l, b.get(k), exp_x);
+        check_approx(x.get(k), exp_x, 1e-9);
+        check_approx(x2.get(k), exp_x, 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_batch_least_squares_matches_single)
+{
+    mt19937 mt;
+    matrix_batch<double, 20, 6> a(40);
+    matrix_batch<double, 20, 1> b(40);
+    random_batch(a, mt);
+    random_batch(b, mt);
+
+    // rank deficient
+    auto m = a.get(11);
+    for (size_t i = 0; i < 20; ++i)
+    {
+        m[i][3] = 2.0 * m[i][1];
+    }
+    a.set(11, m);
+
+    matrix_batch<double, 6, 1> x;
+    bool ok[40];
+    BOOST_CHECK(!solve_least_squares(a, b, x, ok, 1e-12));
+
+    for (size_t k = 0; k < a.size(); ++k)
+    {
+        matrix<double, 6, 1> exp_x;
+        bool exp_ok = solve_least_squares(a.get(k), b.get(k), exp_x, 1e-12);
+        BOOST_CHECK_EQUAL(ok[k], exp_ok);
+        BOOST_CHECK_EQUAL(ok[k], k != 11);
+        if (exp_ok)
+        {
+            check_approx(x.get(k), exp_x, 1e-9);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
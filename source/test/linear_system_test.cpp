@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <random>
 #include <utility>
 #include <boost/test/unit_test.hpp>
 #include "kismet/math/linear_system.h"
@@ -71,6 +72,22 @@ BOOST_AUTO_TEST_CASE(linear_system_GE_solve_identity)
     KISMET_CHECK_EQUAL_COLLECTIONS(x, expected_x);
 }
 
+BOOST_AUTO_TEST_CASE(linear_system_GE_solve_inplace)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+    matrix<float, 3, 1> b{ { 2 }, { 9 }, { -8 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+
+    // x refers to b
+    BOOST_CHECK(solve_partial_pivoting_inplace(a, b, b));
+    KISMET_CHECK_APPROX_COLLECTIONS(b, exp_x);
+}
+
 BOOST_AUTO_TEST_CASE(linear_system_GE_solve_non_invertible_fail)
 {
     matrix22f a
@@ -224,4 +241,516 @@ BOOST_AUTO_TEST_CASE(linear_system_plu_decompose)
     KISMET_CHECK_EQUAL_COLLECTIONS(p_array, exp_p_array);
 }
 
+BOOST_AUTO_TEST_CASE(linear_system_plu_decompose_packed)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+
+    // L below the diagonal, U on and above the diagonal
+    matrix33f exp_lu
+    {
+        { 2, -5, 12 },
+        { 0, 2, -10 },
+        { 0.5f, 0.25f, -0.5f }
+    };
+
+    size_t exp_p[] = { 2, 0, 1 };
+
+    matrix33f lu;
+    size_t p[3];
+    plu_decompose_packed(a, p, lu);
+
+    KISMET_CHECK_EQUAL_COLLECTIONS(p, exp_p);
+    KISMET_CHECK_APPROX_COLLECTIONS(lu, exp_lu);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_solve)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+    matrix<float, 3, 1> b{ { 2 }, { 9 }, { -8 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+
+    matrix33f lu;
+    size_t p[3];
+    plu_decompose_packed(a, p, lu);
+
+    matrix<float, 3, 1> x;
+    BOOST_CHECK(plu_solve(lu, p, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_solve_non_invertible_fail)
+{
+    matrix22f a
+    {
+        { 1, 2 },
+        { 2, 4 }
+    };
+    matrix<float, 2, 1> b{ { 1 }, { 2 } };
+
+    matrix22f lu;
+    size_t p[2];
+    plu_decompose_packed(a, p, lu);
+
+    matrix<float, 2, 1> x;
+    BOOST_CHECK(!plu_solve(lu, p, b, x));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_solve_transposed)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+    // a^T * (1, 1, 1)
+    matrix<float, 3, 1> b{ { 3 }, { -5 }, { 5 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+
+    matrix33f lu;
+    size_t p[3];
+    plu_decompose_packed(a, p, lu);
+
+    matrix<float, 3, 1> x;
+    BOOST_CHECK(plu_solve_transposed(lu, p, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_lu_decompose_branchless)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+
+    matrix33f exp_l, exp_u;
+    BOOST_REQUIRE(lu_decompose(a, exp_l, exp_u));
+
+    matrix33f l, u;
+    BOOST_CHECK(lu_decompose_branchless(a, l, u));
+    KISMET_CHECK_APPROX_COLLECTIONS(l, exp_l);
+    KISMET_CHECK_APPROX_COLLECTIONS(u, exp_u);
+
+    // a zero pivot is fine as long as its column is zero below it
+    matrix33f zero_pivot
+    {
+        { 0, -2, 3 },
+        { 0, -5, 12 },
+        { 0, 2, -10 }
+    };
+    BOOST_REQUIRE(lu_decompose(zero_pivot, exp_l, exp_u));
+    BOOST_CHECK(lu_decompose_branchless(zero_pivot, l, u));
+    KISMET_CHECK_APPROX_COLLECTIONS(l, exp_l);
+    KISMET_CHECK_APPROX_COLLECTIONS(u, exp_u);
+
+    matrix22f fail
+    {
+        { 0, 2 },
+        { 1, 0 },
+    };
+    matrix22f l2, u2;
+    BOOST_CHECK(!lu_decompose_branchless(fail, l2, u2));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_decompose_packed_branchless)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+
+    matrix33f exp_lu;
+    size_t exp_p[3];
+    plu_decompose_packed(a, exp_p, exp_lu);
+
+    matrix33f lu;
+    size_t p[3];
+    BOOST_CHECK(plu_decompose_packed_branchless(a, p, lu));
+    KISMET_CHECK_EQUAL_COLLECTIONS(p, exp_p);
+    KISMET_CHECK_APPROX_COLLECTIONS(lu, exp_lu);
+
+    matrix<float, 3, 1> b{ { 2 }, { 9 }, { -8 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+    matrix<float, 3, 1> x;
+    BOOST_CHECK(plu_solve_branchless(lu, p, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_solve_branchless_random)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    for (size_t k = 0; k < 100; ++k)
+    {
+        matrix<double, 6, 6> a;
+        matrix<double, 6, 1> b;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            for (size_t j = 0; j < 6; ++j)
+            {
+                a[i][j] = dis(mt);
+            }
+            b[i][0] = dis(mt);
+        }
+
+        matrix<double, 6, 6> exp_lu;
+        size_t exp_p[6];
+        plu_decompose_packed(a, exp_p, exp_lu);
+        matrix<double, 6, 1> exp_x;
+        BOOST_REQUIRE(plu_solve(exp_lu, exp_p, b, exp_x));
+
+        matrix<double, 6, 6> lu;
+        size_t p[6];
+        BOOST_CHECK(plu_decompose_packed_branchless(a, p, lu));
+        KISMET_CHECK_EQUAL_COLLECTIONS(p, exp_p);
+        KISMET_CHECK_APPROX_COLLECTIONS(lu, exp_lu);
+
+        matrix<double, 6, 1> x;
+        BOOST_CHECK(plu_solve_branchless(lu, p, b, x));
+        for (size_t i = 0; i < 6; ++i)
+        {
+            BOOST_CHECK(approx(x[i][0], exp_x[i][0], 1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_plu_solve_branchless_non_invertible_fail)
+{
+    matrix22f a
+    {
+        { 1, 2 },
+        { 2, 4 }
+    };
+    matrix<float, 2, 1> b{ { 1 }, { 2 } };
+
+    matrix22f lu;
+    size_t p[2];
+    BOOST_CHECK(!plu_decompose_packed_branchless(a, p, lu));
+
+    matrix<float, 2, 1> x;
+    BOOST_CHECK(!plu_solve_branchless(lu, p, b, x));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_substitute_branchless)
+{
+    matrix33f u
+    {
+        { 2, -5, 12 },
+        { 0, 2, -10 },
+        { 0, 0, -0.5f }
+    };
+    matrix33f l = transpose(u);
+    matrix<float, 3, 1> b{ { 9 }, { -8 }, { -0.5f } };
+
+    matrix<float, 3, 1> exp_x, x;
+    BOOST_REQUIRE(backward_substitute(u, b, exp_x));
+    BOOST_CHECK(backward_substitute_branchless(u, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+
+    BOOST_REQUIRE(forward_substitute(l, b, exp_x));
+    BOOST_CHECK(forward_substitute_branchless(l, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+
+    // the unknown of a zero pivot is zero and the others are still computed
+    u[1][1] = 0;
+    BOOST_CHECK(!backward_substitute_branchless(u, b, x));
+    BOOST_CHECK_EQUAL(x[1][0], 0.0f);
+    BOOST_CHECK(approx(x[2][0], 1.0f));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_condition_estimate)
+{
+    // the 1-norm condition number of the 4x4 Hilbert matrix is 28375
+    matrix<double, 4, 4> h;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            h[i][j] = 1.0 / (i + j + 1);
+        }
+    }
+    BOOST_CHECK(approx(norm_1(h), 25.0 / 12.0, 1e-12));
+    BOOST_CHECK(approx(condition_estimate(h), 28375.0, 1e-6 * 28375.0));
+
+    // the estimate is a lower bound of the exact condition number
+    matrix<double, 3, 3> a
+    {
+        { 4, -2, 1 },
+        { 3, 6, -4 },
+        { 2, 1, 8 }
+    };
+    double exact = norm_1(a) * norm_1(invert(a));
+    double estimate = condition_estimate(a);
+    BOOST_CHECK(estimate <= exact * (1.0 + 1e-12));
+    BOOST_CHECK(estimate >= exact / 3.0);
+
+    matrix<double, 2, 2> identity{ { 1, 0 }, { 0, 1 } };
+    BOOST_CHECK(approx(condition_estimate(identity), 1.0, 1e-12));
+
+    matrix<double, 2, 2> singular{ { 1, 2 }, { 2, 4 } };
+    BOOST_CHECK(condition_estimate(singular) == std::numeric_limits<double>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_pluq_decompose)
+{
+    matrix33f a
+    {
+        { 1, -2, 3 },
+        { 2, -5, 12 },
+        { 0, 2, -10 }
+    };
+
+    matrix33f lu;
+    size_t p[3];
+    size_t q[3];
+    BOOST_CHECK_EQUAL(pluq_decompose(a, p, q, lu), 3u);
+
+    // the first pivot is the largest element
+    BOOST_CHECK_EQUAL(p[1], 0u);
+    BOOST_CHECK_EQUAL(q[2], 0u);
+    BOOST_CHECK_EQUAL(lu[0][0], 12.0f);
+
+    matrix<float, 3, 1> b{ { 2 }, { 9 }, { -8 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+    matrix<float, 3, 1> x;
+    BOOST_CHECK(pluq_solve(lu, p, q, b, x));
+    for (size_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(approx(x[i][0], exp_x[i][0], 1e-5f));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_pluq_decompose_rank)
+{
+    // the third row is the sum of the first two
+    matrix33f a
+    {
+        { 1, 2, 3 },
+        { 4, 5, 6 },
+        { 5, 7, 9 }
+    };
+
+    matrix33f lu;
+    size_t p[3];
+    size_t q[3];
+    BOOST_CHECK_EQUAL(pluq_decompose(a, p, q, lu, 1e-5f), 2u);
+    BOOST_CHECK_EQUAL(lu[2][2], 0.0f);
+
+    matrix<float, 3, 1> b{ { 1 }, { 1 }, { 1 } };
+    matrix<float, 3, 1> x;
+    BOOST_CHECK(!pluq_solve(lu, p, q, b, x));
+
+    matrix33f zero{};
+    BOOST_CHECK_EQUAL(pluq_decompose(zero, p, q, lu), 0u);
+
+    // partial pivoting only sees the zero column
+    matrix33f rank_one
+    {
+        { 0, 1, 2 },
+        { 0, 2, 4 },
+        { 0, 3, 6 }
+    };
+    BOOST_CHECK_EQUAL(pluq_decompose(rank_one, p, q, lu), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_solve_mixed_precision)
+{
+    // diagonally dominant, not representable in float
+    matrix<double, 6, 6> a;
+    matrix<double, 6, 1> exp_x;
+    for (size_t i = 0; i < 6; ++i)
+    {
+        for (size_t j = 0; j < 6; ++j)
+        {
+            a[i][j] = i == j ? 10.1 + 0.3 * i : 1.0 / (1.0 + i + 2.0 * j);
+        }
+        exp_x[i][0] = 0.1 * (i + 1) - 0.35;
+    }
+    matrix<double, 6, 1> b = a * exp_x;
+
+    matrix<double, 6, 1> x;
+    mixed_precision_info<double> info;
+    BOOST_CHECK(solve_mixed_precision(a, b, x, 10, &info));
+    BOOST_CHECK(!info.fallback);
+    BOOST_CHECK(info.iterations > 0 && info.iterations <= 4);
+    BOOST_CHECK(info.residual < 1e-14);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        BOOST_CHECK(approx(x[i][0], exp_x[i][0], 1e-14));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_solve_mixed_precision_ill_conditioned_fallback)
+{
+    // the 8x8 Hilbert matrix, whose condition number 1.5e10 is beyond float
+    matrix<double, 8, 8> a;
+    matrix<double, 8, 1> exp_x;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            a[i][j] = 1.0 / (i + j + 1);
+        }
+        exp_x[i][0] = 1.0;
+    }
+    matrix<double, 8, 1> b = a * exp_x;
+
+    matrix<double, 8, 1> x;
+    mixed_precision_info<double> info;
+    BOOST_CHECK(solve_mixed_precision(a, b, x, 10, &info, 1e-20));
+    BOOST_CHECK(info.fallback);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        BOOST_CHECK(approx(x[i][0], 1.0, 1e-5));
+    }
+
+    // beyond the range of float
+    matrix<double, 2, 2> big{ { 1e300, 1.0 }, { 1.0, 1e300 } };
+    matrix<double, 2, 1> c{ { 1e300 }, { 1e300 } };
+    matrix<double, 2, 1> y;
+    BOOST_CHECK(solve_mixed_precision(big, c, y, 10, &info));
+    BOOST_CHECK(info.fallback);
+    BOOST_CHECK(approx(y[0][0], 1.0, 1e-12) && approx(y[1][0], 1.0, 1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_solve_mixed_precision_non_invertible_fail)
+{
+    matrix<double, 2, 2> a{ { 1, 2 }, { 2, 4 } };
+    matrix<double, 2, 1> b{ { 1 }, { 2 } };
+    matrix<double, 2, 1> x;
+    mixed_precision_info<double> info;
+    BOOST_CHECK(!solve_mixed_precision(a, b, x, 10, &info));
+    BOOST_CHECK(info.fallback);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_cholesky_decompose)
+{
+    matrix33f a
+    {
+        { 4, 12, -16 },
+        { 12, 37, -43 },
+        { -16, -43, 98 }
+    };
+
+    matrix33f exp_l
+    {
+        { 2, 0, 0 },
+        { 6, 1, 0 },
+        { -8, 5, 3 }
+    };
+
+    matrix33f l;
+    BOOST_CHECK(cholesky_decompose(a, l));
+    KISMET_CHECK_APPROX_COLLECTIONS(l, exp_l);
+
+    matrix<float, 3, 1> b{ { 0 }, { 6 }, { 39 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+    matrix<float, 3, 1> x;
+    cholesky_solve(l, b, x);
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_cholesky_decompose_not_positive_definite_fail)
+{
+    matrix22f a
+    {
+        { 1, 2 },
+        { 2, 1 }
+    };
+
+    matrix22f l;
+    BOOST_CHECK(!cholesky_decompose(a, l));
+
+    matrix<float, 2, 1> b{ { 1 }, { 1 } };
+    matrix<float, 2, 1> x;
+    BOOST_CHECK(!solve_cholesky(a, b, x));
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_ldlt_decompose)
+{
+    matrix33f a
+    {
+        { 4, 12, -16 },
+        { 12, 37, -43 },
+        { -16, -43, 98 }
+    };
+
+    matrix33f exp_l
+    {
+        { 1, 0, 0 },
+        { 3, 1, 0 },
+        { -4, 5, 1 }
+    };
+    matrix<float, 3, 1> exp_d{ { 4 }, { 1 }, { 9 } };
+
+    matrix33f l;
+    matrix<float, 3, 1> d;
+    BOOST_CHECK(ldlt_decompose(a, l, d));
+    KISMET_CHECK_APPROX_COLLECTIONS(l, exp_l);
+    KISMET_CHECK_APPROX_COLLECTIONS(d, exp_d);
+
+    matrix<float, 3, 1> b{ { 0 }, { 6 }, { 39 } };
+    matrix<float, 3, 1> exp_x{ { 1 }, { 1 }, { 1 } };
+    matrix<float, 3, 1> x;
+    ldlt_solve(l, d, b, x);
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_solve_least_squares)
+{
+    // points on the line y = 2x + 1
+    matrix<double, 4, 2> a
+    {
+        { 0, 1 },
+        { 1, 1 },
+        { 2, 1 },
+        { 3, 1 }
+    };
+    matrix<double, 4, 1> b{ { 1 }, { 3 }, { 5 }, { 7 } };
+    matrix<double, 2, 1> exp_x{ { 2 }, { 1 } };
+
+    matrix<double, 2, 1> x;
+    BOOST_CHECK(solve_least_squares(a, b, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x);
+
+    // overdetermined, compare with the normal equations
+    matrix<double, 4, 1> b2{ { 1 }, { 2 }, { 6 }, { 7 } };
+    matrix<double, 2, 1> exp_x2;
+    BOOST_CHECK(solve_partial_pivoting(transpose(a) * a, transpose(a) * b2, exp_x2));
+
+    matrix<double, 4, 2> qr;
+    matrix<double, 2, 1> rdiag;
+    BOOST_CHECK(qr_decompose(a, qr, rdiag));
+    BOOST_CHECK(qr_solve(qr, rdiag, b2, x));
+    KISMET_CHECK_APPROX_COLLECTIONS(x, exp_x2);
+}
+
+BOOST_AUTO_TEST_CASE(linear_system_solve_least_squares_rank_deficient_fail)
+{
+    matrix<double, 3, 2> a
+    {
+        { 1, 2 },
+        { 2, 4 },
+        { 3, 6 }
+    };
+    matrix<double, 3, 1> b{ { 1 }, { 2 }, { 3 } };
+
+    matrix<double, 2, 1> x;
+    BOOST_CHECK(!solve_least_squares(a, b, x));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include <limits>
 #include "kismet/math/math_trait.h"
+#include "kismet/math/utility.h"
 using namespace kismet::math;
 using namespace std;
 namespace tt = boost::unit_test;
@@ -36,4 +37,36 @@ BOOST_AUTO_TEST_CASE(float_degree_to_radian, * tt::tolerance(0.001f))
     BOOST_TEST(KISMET_PI_F == radians(180.0f));
 }
 
+BOOST_AUTO_TEST_CASE(fast_acos_sin)
+{
+    for (int i = -100; i <= 100; ++i)
+    {
+        double x = i / 100.0;
+        BOOST_CHECK(abs(fast_acos(x) - acos(x)) < 3e-8);
+        BOOST_CHECK(abs(fast_acos(float(x)) - acos(float(x))) < 5e-7f);
+
+        double a = x * KISMET_PI / 2;
+        BOOST_CHECK(abs(fast_sin(a) - sin(a)) < 6e-8);
+        BOOST_CHECK(abs(fast_sin(float(a)) - sin(float(a))) < 2e-7f);
+    }
+    BOOST_CHECK_EQUAL(fast_sinc(0.0), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(fast_sincos_step)
+{
+    for (int i = -100; i <= 100; ++i)
+    {
+        double x = i / 100.0 * KISMET_PI / 2;
+        double s;
+        double c;
+        fast_sincos(x, s, c);
+        BOOST_CHECK(abs(s - sin(x)) < 6e-8);
+        BOOST_CHECK(abs(c - cos(x)) < 1e-8);
+    }
+
+    BOOST_CHECK_EQUAL(step(1.0f, 0.5f), 0.0f);
+    BOOST_CHECK_EQUAL(step(1.0f, 1.0f), 1.0f);
+    BOOST_CHECK_EQUAL(step(1.0f, 2.0f), 1.0f);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
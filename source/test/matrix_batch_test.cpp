@@ -0,0 +1,48 @@
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/matrix.h"
+#include "kismet/math/matrix_batch.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+BOOST_AUTO_TEST_SUITE(matrix_batch_test)
+
+BOOST_AUTO_TEST_CASE(matrix_batch_set_get)
+{
+    matrix_batch<float, 2, 3> batch(5);
+    BOOST_CHECK_EQUAL(batch.size(), 5u);
+    BOOST_CHECK(batch.stride() >= batch.size());
+
+    matrix<float, 2, 3> m
+    {
+        { 1, 2, 3 },
+        { 4, 5, 6 }
+    };
+    batch.set(3, m);
+
+    KISMET_CHECK_EQUAL_COLLECTIONS(batch.get(3), m);
+    BOOST_CHECK_EQUAL(batch.element(1, 2)[3], 6.0f);
+    BOOST_CHECK_EQUAL(batch.element(1, 2)[2], 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_batch_resize_preserves_elements)
+{
+    matrix_batch<double, 2, 2> batch(3);
+    matrix<double, 2, 2> m
+    {
+        { 1, 2 },
+        { 3, 4 }
+    };
+    batch.set(2, m);
+
+    batch.resize(100);
+    BOOST_CHECK_EQUAL(batch.size(), 100u);
+    KISMET_CHECK_EQUAL_COLLECTIONS(batch.get(2), m);
+
+    batch.resize(2);
+    batch.resize(3);
+    KISMET_CHECK_EQUAL_COLLECTIONS(batch.get(2), (matrix<double, 2, 2>{ { 0, 0 }, { 0, 0 } }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -543,6 +543,101 @@ void random_matrix(T& m)
 
 }
 
+BOOST_AUTO_TEST_CASE(matrix_inverse_1x1)
+{
+    matrix<float, 1, 1> m{ { 4 } };
+    matrix<float, 1, 1> inverse;
+    BOOST_CHECK(invert(m, inverse));
+    BOOST_CHECK_EQUAL(inverse[0][0], 0.25f);
+
+    m[0][0] = 0;
+    BOOST_CHECK(!invert(m, inverse));
+}
+
+BOOST_AUTO_TEST_CASE(matrix_inverse_8x8_succeeds)
+{
+    matrix<double, 8, 8> m;
+    random_matrix(m);
+
+    matrix<double, 8, 8> inverse;
+    BOOST_CHECK(invert(m, inverse));
+
+    auto identity = m * inverse;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            BOOST_CHECK(approx(identity[i][j], i == j ? 1.0 : 0.0, 1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matrix_inverse_6x6_fails)
+{
+    matrix<double, 6, 6> m;
+    random_matrix(m);
+    m[4] = m[1];
+
+    matrix<double, 6, 6> inverse;
+    BOOST_CHECK(!invert(m, inverse, 1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(matrix_determinant)
+{
+    matrix22f m2
+    {
+        { 1, 2 },
+        { 4, 4 }
+    };
+    BOOST_CHECK(approx(determinant(m2), -4.0f));
+
+    matrix33f m3
+    {
+        { 1, 2, 4 },
+        { 2, 2, 4 },
+        { 4, 4, 4 }
+    };
+    BOOST_CHECK(approx(determinant(m3), 8.0f));
+
+    // needs row swaps, each flips the sign
+    matrix<double, 4, 4> m4
+    {
+        { 0, 1, 0, 0 },
+        { 0, 0, 2, 0 },
+        { 3, 0, 0, 0 },
+        { 0, 0, 0, 4 }
+    };
+    BOOST_CHECK(approx(determinant(m4), 24.0));
+
+    matrix<float, 5, 5> m5
+    {
+        { 1,   2,  4,  8, 16 },
+        { 2,   2,  4,  8, 16 },
+        { 4,   4,  4,  8, 16 },
+        { 8,   8,  8,  8, 16 },
+        { 16, 16, 16, 16, 16 }
+    };
+    BOOST_CHECK(approx(determinant(m5), 1024.0f, 1e-3f));
+
+    // matches the product of the inverse's determinant
+    matrix<double, 7, 7> m7;
+    random_matrix(m7);
+    BOOST_CHECK(approx(determinant(m7) * determinant(invert(m7)), 1.0, 1e-9));
+
+    m7[3] = m7[5];
+    BOOST_CHECK(approx(determinant(m7), 0.0, 1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(matrix_transpose_inplace)
+{
+    matrix<double, 5, 5> m;
+    random_matrix(m);
+
+    auto exp_t = transpose(m);
+    transpose_inplace(m);
+    KISMET_CHECK_EQUAL_COLLECTIONS(m, exp_t);
+}
+
 BOOST_AUTO_TEST_CASE(matrix_mul)
 {
     matrix33f m1(matrix33f::identity);
@@ -553,6 +648,80 @@ BOOST_AUTO_TEST_CASE(matrix_mul)
     BOOST_CHECK_EQUAL(m3, m2);
 }
 
+BOOST_AUTO_TEST_CASE(matrix_multiply_into)
+{
+    matrix<float, 2, 3> m1
+    {
+        { 1, 2, 3 },
+        { 4, 5, 6 }
+    };
+
+    matrix<float, 3, 2> m2
+    {
+        { 1, -1 },
+        { 0, 2 },
+        { -2, 1 }
+    };
+
+    matrix22f exp_m
+    {
+        { -5, 6 },
+        { -8, 12 }
+    };
+
+    matrix22f m;
+    multiply_into(m, m1, m2);
+    KISMET_CHECK_EQUAL_COLLECTIONS(m, exp_m);
+    KISMET_CHECK_EQUAL_COLLECTIONS(m1 * m2, exp_m);
+
+    matrix22f a(exp_m);
+    a *= matrix22f::identity;
+    KISMET_CHECK_EQUAL_COLLECTIONS(a, exp_m);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_arithmetic)
+{
+    matrix22f m1
+    {
+        { 1, 2 },
+        { 3, 4 }
+    };
+
+    matrix22f m2
+    {
+        { 4, 3 },
+        { 2, 1 }
+    };
+
+    matrix22f exp_sum
+    {
+        { 5, 5 },
+        { 5, 5 }
+    };
+
+    matrix22f exp_diff
+    {
+        { -3, -1 },
+        { 1, 3 }
+    };
+
+    matrix22f exp_scaled
+    {
+        { 2, 4 },
+        { 6, 8 }
+    };
+
+    KISMET_CHECK_EQUAL_COLLECTIONS(m1 + m2, exp_sum);
+    KISMET_CHECK_EQUAL_COLLECTIONS(m1 - m2, exp_diff);
+    KISMET_CHECK_EQUAL_COLLECTIONS(2.0f * m1, exp_scaled);
+    KISMET_CHECK_EQUAL_COLLECTIONS(m1 * 2, exp_scaled);
+    KISMET_CHECK_APPROX_COLLECTIONS(exp_scaled / 2.0f, m1);
+
+    // the element type is the common type
+    matrix<double, 2, 2> scaled = m1 * 2.0;
+    BOOST_CHECK_EQUAL(scaled[1][1], 8.0);
+}
+
 BOOST_AUTO_TEST_CASE(matrix_vector_assign)
 {
     matrix33f m(matrix33f::identity);
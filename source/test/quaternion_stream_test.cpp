@@ -0,0 +1,205 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/quaternion.h"
+#include "kismet/math/quaternion_stream.h"
+#include "kismet/math/vector_stream.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t stream_size = 37;
+
+template<typename T = float>
+std::vector<quaternion<T>> random_rotations(std::mt19937& mt)
+{
+    std::uniform_real_distribution<T> dis(T(-1), T(1));
+    std::vector<quaternion<T>> q(stream_size);
+    for (auto& e : q)
+    {
+        e = quaternion<T>(dis(mt), dis(mt), dis(mt), dis(mt));
+        e.normalize();
+    }
+    return q;
+}
+
+std::vector<vector3f> random_vectors(std::mt19937& mt)
+{
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    std::vector<vector3f> v(stream_size);
+    for (auto& e : v)
+    {
+        e = vector3f(dis(mt), dis(mt), dis(mt));
+    }
+    return v;
+}
+
+// reference slerp along the shortest path in double
+template<typename T>
+quaterniond reference_slerp(quaternion<T> const& q0, quaternion<T> const& q1, T t)
+{
+    quaterniond a(q0.w(), q0.x(), q0.y(), q0.z());
+    quaterniond b(q1.w(), q1.x(), q1.y(), q1.z());
+    if (dot(a, b) < 0)
+    {
+        b = -1.0 * b;
+    }
+    return slerp(a, b, double(t));
+}
+
+template<typename T>
+void check_approx(quaternion<T> const& q, quaterniond const& exp_q, double tolerance)
+{
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        BOOST_CHECK(approx(double(q[i]), exp_q[i], tolerance));
+    }
+}
+
+// tolerance and shared_tolerance are the documented errors of the slerp overloads
+template<typename T>
+void check_slerp(double tolerance, double shared_tolerance)
+{
+    std::mt19937 mt;
+    auto a = random_rotations<T>(mt);
+    auto b = random_rotations<T>(mt);
+    std::uniform_real_distribution<T> dis(T(0), T(1));
+    std::vector<T> t(stream_size);
+    for (auto& e : t)
+    {
+        e = dis(mt);
+    }
+
+    // nearly parallel, identical and opposite quaternions
+    b[1] = a[1] + quaternion<T>(T(0), T(1e-4), T(0), T(-1e-4));
+    b[1].normalize();
+    b[2] = a[2];
+    b[3] = T(-1) * a[3];
+    t[4] = T(0);
+    t[5] = T(1);
+
+    quaternion_stream<T> sa(a.begin(), a.end());
+    quaternion_stream<T> sb(b.begin(), b.end());
+
+    quaternion_stream<T> out;
+    slerp(sa, sb, t.data(), out);
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        check_approx(out.get(k), reference_slerp(a[k], b[k], t[k]), tolerance);
+    }
+
+    for (T shared_t : { T(0), T(0.3), T(0.5), T(0.7), T(1) })
+    {
+        // in place
+        quaternion_stream<T> sc(a.begin(), a.end());
+        slerp(sc, sb, shared_t, sc);
+        for (std::size_t k = 0; k < stream_size; ++k)
+        {
+            check_approx(sc.get(k), reference_slerp(a[k], b[k], shared_t), shared_tolerance);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(quaternion_stream_test)
+
+BOOST_AUTO_TEST_CASE(quaternion_stream_conversion)
+{
+    std::mt19937 mt;
+    auto q = random_rotations(mt);
+
+    quaternion_stream<float> s(q.begin(), q.end());
+    BOOST_CHECK_EQUAL(s.size(), stream_size);
+    BOOST_CHECK_EQUAL(s.x()[3], q[3].x());
+
+    std::vector<quaternionf> out(stream_size);
+    s.copy_to(out.begin());
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_EQUAL_COLLECTIONS(out[k], q[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_stream_rotate)
+{
+    std::mt19937 mt;
+    auto q = random_rotations(mt);
+    auto v = random_vectors(mt);
+
+    quaternion_stream<float> sq(q.begin(), q.end());
+    vector_stream<float, 3> sv(v.begin(), v.end());
+
+    vector_stream<float, 3> out;
+    rotate(q[0], sv, out);
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_APPROX_COLLECTIONS(out.get(k), q[0] * v[k]);
+    }
+
+    // in place
+    rotate(sq, sv, sv);
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_APPROX_COLLECTIONS(sv.get(k), q[k] * v[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_stream_multiply)
+{
+    std::mt19937 mt;
+    auto a = random_rotations(mt);
+    auto b = random_rotations(mt);
+
+    quaternion_stream<float> sa(a.begin(), a.end());
+    quaternion_stream<float> sb(b.begin(), b.end());
+
+    quaternion_stream<float> out;
+    multiply(sa, sb, out);
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_APPROX_COLLECTIONS(out.get(k), a[k] * b[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_stream_nlerp)
+{
+    std::mt19937 mt;
+    auto a = random_rotations(mt);
+    auto b = random_rotations(mt);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::vector<float> t(stream_size);
+    for (auto& e : t)
+    {
+        e = dis(mt);
+    }
+
+    quaternion_stream<float> sa(a.begin(), a.end());
+    quaternion_stream<float> sb(b.begin(), b.end());
+
+    quaternion_stream<float> shared;
+    quaternion_stream<float> out;
+    nlerp(sa, sb, 0.25f, shared);
+    nlerp(sa, sb, t.data(), out);
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        // the batch version takes the shortest path
+        quaternionf bk = dot(a[k], b[k]) < 0 ? -1.0f * b[k] : b[k];
+        KISMET_CHECK_APPROX_COLLECTIONS(shared.get(k), nlerp(a[k], bk, 0.25f));
+        KISMET_CHECK_APPROX_COLLECTIONS(out.get(k), nlerp(a[k], bk, t[k]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_stream_slerp)
+{
+    check_slerp<float>(2e-7, 2e-7);
+    check_slerp<double>(1e-8, 1e-7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -28,4 +28,19 @@ BOOST_AUTO_TEST_CASE(quaternion_rotate_vector)
     BOOST_CHECK_EQUAL(rot_around_x * vector3f::up, vector3f::back);
 }
 
+BOOST_AUTO_TEST_CASE(quaternion_product)
+{
+    quaternionf i(0.0f, 1.0f, 0.0f, 0.0f);
+    quaternionf j(0.0f, 0.0f, 1.0f, 0.0f);
+    quaternionf k(0.0f, 0.0f, 0.0f, 1.0f);
+    BOOST_CHECK_EQUAL(i * j, k);
+    BOOST_CHECK_EQUAL(j * i, -k);
+    BOOST_CHECK_EQUAL(i * i, quaternionf(-1.0f, 0.0f, 0.0f, 0.0f));
+
+    // the product applies the right hand side first
+    quaternionf rot_around_z(vector3f::forward, deg2rad(90.0f));
+    quaternionf rot_around_y(vector3f::up, deg2rad(90.0f));
+    BOOST_CHECK_EQUAL((rot_around_z * rot_around_y) * vector3f::right, rot_around_z * (rot_around_y * vector3f::right));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
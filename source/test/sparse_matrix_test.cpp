@@ -0,0 +1,230 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "kismet/math/sparse_matrix.h"
+
+using namespace std;
+using namespace kismet::math;
+
+namespace
+{
+
+// y = A*x using element access
+template<typename Matrix>
+std::vector<double> dense_multiply(Matrix const& a, std::vector<double> const& x)
+{
+    std::vector<double> y(a.rows(), 0);
+    for (size_t i = 0; i < a.rows(); ++i)
+    {
+        for (size_t j = 0; j < a.cols(); ++j)
+        {
+            y[i] += a(i, j) * x[j];
+        }
+    }
+    return y;
+}
+
+void check_approx(std::vector<double> const& x, std::vector<double> const& exp_x)
+{
+    BOOST_REQUIRE_EQUAL(x.size(), exp_x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        BOOST_CHECK(approx(x[i], exp_x[i], 1e-9));
+    }
+}
+
+// a random banded matrix with a dominant diagonal
+std::vector<triplet<double>> random_banded(size_t n, size_t band, mt19937& mt)
+{
+    uniform_real_distribution<double> dis(-1, 1);
+    std::vector<triplet<double>> t;
+    for (size_t i = 0; i < n; ++i)
+    {
+        t.push_back({ i, i, 2.0 * band + 1 });
+        for (size_t j = i > band ? i - band : 0; j < i + band + 1 && j < n; ++j)
+        {
+            if (j != i)
+            {
+                t.push_back({ i, j, dis(mt) });
+            }
+        }
+    }
+    shuffle(t.begin(), t.end(), mt);
+    return t;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(sparse_matrix_test)
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_csr_from_triplets)
+{
+    std::vector<triplet<double>> t
+    {
+        { 2, 1, 5 },
+        { 0, 2, 2 },
+        { 0, 0, 1 },
+        { 2, 1, 1 },
+        { 1, 1, 3 }
+    };
+    csr_matrix<double> a(3, 3, t.begin(), t.end());
+
+    BOOST_CHECK_EQUAL(a.rows(), 3u);
+    BOOST_CHECK_EQUAL(a.cols(), 3u);
+    // duplicates are merged
+    BOOST_CHECK_EQUAL(a.non_zeros(), 4u);
+
+    size_t exp_offsets[] = { 0, 2, 3, 4 };
+    size_t exp_indices[] = { 0, 2, 1, 1 };
+    double exp_values[] = { 1, 2, 3, 6 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.row_offsets(), a.row_offsets() + 4, begin(exp_offsets), end(exp_offsets));
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.column_indices(), a.column_indices() + 4, begin(exp_indices), end(exp_indices));
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.values(), a.values() + 4, begin(exp_values), end(exp_values));
+
+    BOOST_CHECK_EQUAL(a(2, 1), 6);
+    BOOST_CHECK_EQUAL(a(1, 0), 0);
+    BOOST_CHECK(!a.find(1, 2));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_csr_multiply)
+{
+    mt19937 mt;
+    uniform_real_distribution<double> dis(-1, 1);
+
+    // large enough to be multiplied in parallel
+    const size_t n = 1000;
+    auto t = random_banded(n, 3, mt);
+    csr_matrix<double> a(n, n, t.begin(), t.end());
+
+    std::vector<double> x(n);
+    generate(x.begin(), x.end(), [&] { return dis(mt); });
+
+    std::vector<double> y(n);
+    multiply(a, x.begin(), y.begin());
+    check_approx(y, dense_multiply(a, x));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_csr_substitute)
+{
+    mt19937 mt;
+    const size_t n = 50;
+    auto t = random_banded(n, 2, mt);
+
+    std::vector<triplet<double>> lower;
+    std::vector<triplet<double>> upper;
+    for (auto const& e : t)
+    {
+        (e.col <= e.row ? lower : upper).push_back(e);
+        if (e.col == e.row)
+        {
+            upper.push_back(e);
+        }
+    }
+    csr_matrix<double> l(n, n, lower.begin(), lower.end());
+    csr_matrix<double> u(n, n, upper.begin(), upper.end());
+
+    std::vector<double> exp_x(n);
+    uniform_real_distribution<double> dis(-1, 1);
+    generate(exp_x.begin(), exp_x.end(), [&] { return dis(mt); });
+
+    std::vector<double> x(n);
+    std::vector<double> b = dense_multiply(l, exp_x);
+    BOOST_CHECK(forward_substitute(l, b.begin(), x.begin()));
+    check_approx(x, exp_x);
+
+    b = dense_multiply(u, exp_x);
+    BOOST_CHECK(backward_substitute(u, b.begin(), x.begin()));
+    check_approx(x, exp_x);
+
+    // the full matrix works too, the other triangle is ignored
+    csr_matrix<double> a(n, n, t.begin(), t.end());
+    BOOST_CHECK(backward_substitute(a, b.begin(), b.begin()));
+    check_approx(b, exp_x);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_csr_substitute_missing_diagonal_fail)
+{
+    std::vector<triplet<double>> t{ { 0, 0, 1 }, { 1, 0, 1 }, { 2, 2, 1 } };
+    csr_matrix<double> a(3, 3, t.begin(), t.end());
+
+    double b[] = { 1, 1, 1 };
+    double x[3];
+    BOOST_CHECK(!forward_substitute(a, b, x));
+    BOOST_CHECK(!backward_substitute(a, b, x));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_bsr)
+{
+    mt19937 mt;
+    uniform_real_distribution<double> dis(-1, 1);
+
+    auto random_block = [&](double diagonal)
+    {
+        matrix<double, 3, 3> m;
+        generate(m.begin(), m.end(), [&] { return dis(mt); });
+        for (size_t i = 0; i < 3; ++i)
+        {
+            m[i][i] += diagonal;
+        }
+        return m;
+    };
+
+    // block tridiagonal, like a chain of bodies
+    const size_t n = 100;
+    std::vector<block_triplet<double, 3>> t;
+    for (size_t i = 0; i < n; ++i)
+    {
+        t.push_back({ i, i, random_block(10) });
+        if (i > 0)
+        {
+            t.push_back({ i, i - 1, random_block(0) });
+        }
+        if (i + 1 < n)
+        {
+            t.push_back({ i, i + 1, random_block(0) });
+        }
+    }
+    // duplicate blocks are summed
+    t.push_back({ 5, 5, random_block(0) });
+    shuffle(t.begin(), t.end(), mt);
+
+    bsr_matrix<double, 3> a(n, n, t.begin(), t.end());
+    BOOST_CHECK_EQUAL(a.rows(), 3 * n);
+    BOOST_CHECK_EQUAL(a.non_zero_blocks(), 3 * n - 2);
+
+    std::vector<double> x(3 * n);
+    generate(x.begin(), x.end(), [&] { return dis(mt); });
+
+    std::vector<double> y(3 * n);
+    multiply(a, x.begin(), y.begin());
+    check_approx(y, dense_multiply(a, x));
+
+    // solve with the block lower and upper parts
+    std::vector<block_triplet<double, 3>> lower;
+    std::vector<block_triplet<double, 3>> upper;
+    for (auto const& e : t)
+    {
+        if (e.col <= e.row)
+        {
+            lower.push_back(e);
+        }
+        if (e.col >= e.row)
+        {
+            upper.push_back(e);
+        }
+    }
+    bsr_matrix<double, 3> l(n, n, lower.begin(), lower.end());
+    bsr_matrix<double, 3> u(n, n, upper.begin(), upper.end());
+
+    std::vector<double> b = dense_multiply(l, x);
+    std::vector<double> x2(3 * n);
+    BOOST_CHECK(forward_substitute(l, b.begin(), x2.begin()));
+    check_approx(x2, x);
+
+    b = dense_multiply(u, x);
+    BOOST_CHECK(backward_substitute(u, b.begin(), x2.begin()));
+    check_approx(x2, x);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
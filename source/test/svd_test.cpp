@@ -0,0 +1,228 @@
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/svd.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t batch_size = 37;
+
+template<typename T>
+T det(matrix<T, 3, 3> const& m)
+{
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+         - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+         + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+template<typename T>
+void check_rotation(matrix<T, 3, 3> const& r, T tolerance)
+{
+    matrix<T, 3, 3> rtr = transpose(r) * r;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            BOOST_CHECK(approx(rtr[i][j], i == j ? T(1) : T(0), tolerance));
+        }
+    }
+    BOOST_CHECK(approx(det(r), T(1), tolerance));
+}
+
+template<typename T>
+void check_svd(matrix<T, 3, 3> const& a, matrix<T, 3, 3> const& u, vector3<T> const& sigma,
+               matrix<T, 3, 3> const& v, T tolerance)
+{
+    check_rotation(u, tolerance);
+    check_rotation(v, tolerance);
+    BOOST_CHECK(sigma[0] >= sigma[1] && sigma[1] >= std::abs(sigma[2]));
+    // the sign of a rank 2 matrix is rounding noise
+    BOOST_CHECK(det(a) * sigma[2] >= -tolerance);
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            T e(0);
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                e += u[i][k] * sigma[k] * v[j][k];
+            }
+            BOOST_CHECK(approx(e, a[i][j], tolerance));
+        }
+    }
+}
+
+template<typename T>
+void check_polar(matrix<T, 3, 3> const& a, matrix<T, 3, 3> const& r, matrix<T, 3, 3> const& s, T tolerance)
+{
+    check_rotation(r, tolerance);
+    matrix<T, 3, 3> rs = r * s;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            BOOST_CHECK(approx(s[i][j], s[j][i], tolerance));
+            BOOST_CHECK(approx(rs[i][j], a[i][j], tolerance));
+        }
+    }
+}
+
+template<typename T>
+void check_random(T tolerance)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<T> dis(T(-2), T(2));
+    for (std::size_t k = 0; k < 100; ++k)
+    {
+        matrix<T, 3, 3> a;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                a[i][j] = dis(mt);
+            }
+        }
+
+        matrix<T, 3, 3> u;
+        matrix<T, 3, 3> v;
+        vector3<T> sigma;
+        BOOST_CHECK(svd_decompose(a, u, sigma, v));
+        check_svd(a, u, sigma, v, tolerance);
+
+        matrix<T, 3, 3> r;
+        matrix<T, 3, 3> s;
+        BOOST_CHECK(polar_decompose(a, r, s));
+        check_polar(a, r, s, tolerance);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(svd_test)
+
+BOOST_AUTO_TEST_CASE(svd_random)
+{
+    check_random<float>(1e-5f);
+    check_random<double>(1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(svd_special)
+{
+    matrix<double, 3, 3> u;
+    matrix<double, 3, 3> v;
+    vector3<double> sigma;
+
+    const matrix<double, 3, 3> special[] = {
+        // zero, rank 1 and rank 2
+        matrix<double, 3, 3>{},
+        matrix<double, 3, 3>{ { 1.0, 2.0, 3.0 }, { 2.0, 4.0, 6.0 }, { -1.0, -2.0, -3.0 } },
+        matrix<double, 3, 3>{ { 1.0, 0.0, 1.0 }, { 0.0, 1.0, 1.0 }, { 1.0, 1.0, 2.0 } },
+        // a reflection, repeated singular values and a scaled permutation
+        matrix<double, 3, 3>{ { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, -1.0 } },
+        matrix<double, 3, 3>{ { 2.0, 0.0, 0.0 }, { 0.0, 2.0, 0.0 }, { 0.0, 0.0, 2.0 } },
+        matrix<double, 3, 3>{ { 0.0, 3.0, 0.0 }, { 0.0, 0.0, 1.0 }, { 2.0, 0.0, 0.0 } },
+        // shear
+        matrix<double, 3, 3>{ { 1.0, 0.5, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } }
+    };
+    for (auto const& a : special)
+    {
+        BOOST_CHECK(svd_decompose(a, u, sigma, v));
+        check_svd(a, u, sigma, v, 1e-12);
+    }
+
+    BOOST_CHECK(svd_decompose(special[3], u, sigma, v));
+    BOOST_CHECK(approx(sigma[2], -1.0, 1e-12));
+    BOOST_CHECK(svd_decompose(special[5], u, sigma, v));
+    BOOST_CHECK(approx(sigma[0], 3.0, 1e-12));
+    BOOST_CHECK(approx(sigma[1], 2.0, 1e-12));
+    BOOST_CHECK(approx(sigma[2], 1.0, 1e-12));
+
+    // the stretch of an inverted element is negative along the smallest direction
+    matrix<double, 3, 3> r;
+    matrix<double, 3, 3> s;
+    matrix<double, 3, 3> inverted{ { 2.0, 0.0, 0.0 }, { 0.0, -0.5, 0.0 }, { 0.0, 0.0, 3.0 } };
+    BOOST_CHECK(polar_decompose(inverted, r, s));
+    check_polar(inverted, r, s, 1e-12);
+    BOOST_CHECK(approx(s[1][1], -0.5, 1e-12));
+
+    matrix<double, 3, 3> nan{ { std::nan(""), 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    BOOST_CHECK(!svd_decompose(nan, u, sigma, v));
+}
+
+BOOST_AUTO_TEST_CASE(svd_batch)
+{
+    std::mt19937 mt;
+    std::uniform_real_distribution<float> dis(-2.0f, 2.0f);
+    matrix_batch<float, 3, 3> a(batch_size);
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        matrix33f m;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                m[i][j] = dis(mt);
+            }
+        }
+        if (k % 5 == 1)
+        {
+            // rank 2
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                m[i][2] = m[i][0] - m[i][1];
+            }
+        }
+        a.set(k, m);
+    }
+
+    matrix_batch<float, 3, 3> u;
+    matrix_batch<float, 3, 3> v;
+    vector_stream<float, 3> sigma;
+    svd_decompose(a, u, sigma, v);
+    BOOST_REQUIRE_EQUAL(u.size(), batch_size);
+    BOOST_REQUIRE_EQUAL(sigma.size(), batch_size);
+    BOOST_REQUIRE_EQUAL(v.size(), batch_size);
+
+    matrix_batch<float, 3, 3> r;
+    matrix_batch<float, 3, 3> s;
+    polar_decompose(a, r, s);
+    BOOST_REQUIRE_EQUAL(r.size(), batch_size);
+    BOOST_REQUIRE_EQUAL(s.size(), batch_size);
+
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        check_svd(a.get(k), u.get(k), sigma.get(k), v.get(k), 1e-5f);
+        check_polar(a.get(k), r.get(k), s.get(k), 1e-5f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(svd_batch_keeps_zero_padding)
+{
+    // the zero padding has rotations for U, V and R
+    matrix_batch<float, 3, 3> a(3);
+    a.set(0, matrix33f{ { 2.0f, 0.0f, 0.0f }, { 0.0f, -0.5f, 0.0f }, { 0.0f, 0.0f, 3.0f } });
+
+    matrix_batch<float, 3, 3> u;
+    matrix_batch<float, 3, 3> v;
+    vector_stream<float, 3> sigma;
+    svd_decompose(a, u, sigma, v);
+    kismet::test::check_zero_padding(u);
+    kismet::test::check_zero_padding(sigma);
+    kismet::test::check_zero_padding(v);
+
+    matrix_batch<float, 3, 3> r;
+    matrix_batch<float, 3, 3> s;
+    polar_decompose(a, r, s);
+    kismet::test::check_zero_padding(r);
+    kismet::test::check_zero_padding(s);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/transform.h"
+#include "kismet/math/transform_batch.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t batch_size = 37;
+
+// q and -q are the same rotation
+void check_same_rotation(quaternionf const& q, quaternionf const& exp_q, float tolerance)
+{
+    float sign = dot(q, exp_q) < 0.0f ? -1.0f : 1.0f;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        BOOST_CHECK(approx(sign * q[i], exp_q[i], tolerance));
+    }
+}
+
+template<std::size_t N>
+void check_rotation(matrix<float, N, N> const& m, matrix44<float> const& exp_m, float tolerance)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            BOOST_CHECK(approx(m[i][j], exp_m[i][j], tolerance));
+        }
+    }
+}
+
+std::vector<vector3f> random_angles(std::mt19937& mt)
+{
+    // beyond [-pi, pi] to exercise the range reduction
+    std::uniform_real_distribution<float> dis(-3.0f * KISMET_PI_F, 3.0f * KISMET_PI_F);
+    std::vector<vector3f> e(batch_size);
+    for (auto& v : e)
+    {
+        v = vector3f(dis(mt), dis(mt), dis(mt));
+    }
+    return e;
+}
+
+std::vector<quaternionf> random_rotations(std::mt19937& mt)
+{
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    std::vector<quaternionf> q(batch_size);
+    for (auto& e : q)
+    {
+        e = quaternionf(dis(mt), dis(mt), dis(mt), dis(mt));
+        e.normalize();
+    }
+
+    // rotations by pi, whose matrices have trace -1
+    q[0] = quaternionf(0.0f, 1.0f, 0.0f, 0.0f);
+    q[1] = quaternionf(0.0f, 0.0f, 1.0f, 0.0f);
+    q[2] = quaternionf(0.0f, 0.0f, 0.0f, 1.0f);
+    q[3] = quaternionf::identity;
+    return q;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(transform_batch_test)
+
+BOOST_AUTO_TEST_CASE(quaternion_from_euler)
+{
+    vector3f e(0.3f, -1.2f, 2.5f);
+    quaternionf q = quat_from_euler_yxz(e);
+    check_same_rotation(q, matrix_to_quat(euler_yxz_to_matrix(e)), 1e-5f);
+    check_rotation(matrix_rotate(q), euler_yxz_to_matrix(e), 1e-5f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_to_quaternion_largest_z)
+{
+    // trace < 0 and the largest diagonal element is m[2][2]
+    vector3f axis(0.1f, 0.2f, 1.0f);
+    axis.normalize();
+    quaternionf q(axis, 3.0f);
+    check_same_rotation(matrix_to_quat(matrix_rotate(q)), q, 1e-5f);
+}
+
+BOOST_AUTO_TEST_CASE(batch_euler_conversion)
+{
+    std::mt19937 mt;
+    auto e = random_angles(mt);
+    vector_stream<float, 3> se(e.begin(), e.end());
+
+    quaternion_stream<float> q;
+    quat_from_euler_yxz(se, q);
+
+    matrix_batch<float, 3, 3> m3;
+    matrix_batch<float, 4, 4> m4;
+    euler_yxz_to_matrix(se, m3);
+    euler_yxz_to_matrix(se, m4);
+
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        check_same_rotation(q.get(k), quat_from_euler_yxz(e[k]), 1e-5f);
+        check_rotation(m3.get(k), euler_yxz_to_matrix(e[k]), 1e-5f);
+        check_rotation(m4.get(k), euler_yxz_to_matrix(e[k]), 1e-5f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_quaternion_matrix_conversion)
+{
+    std::mt19937 mt;
+    auto q = random_rotations(mt);
+    quaternion_stream<float> sq(q.begin(), q.end());
+
+    matrix_batch<float, 4, 4> m;
+    matrix_rotate(sq, m);
+    matrix_batch<float, 3, 3> m3;
+    matrix_rotate(sq, m3);
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        check_rotation(m.get(k), matrix_rotate(q[k]), 1e-6f);
+        check_rotation(m3.get(k), matrix_rotate(q[k]), 1e-6f);
+    }
+
+    quaternion_stream<float> out;
+    matrix_to_quat(m, out);
+    for (std::size_t k = 0; k < batch_size; ++k)
+    {
+        check_same_rotation(out.get(k), q[k], 1e-5f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_conversion_keeps_zero_padding)
+{
+    // the zero padding doesn't convert to zeros
+    std::vector<vector3f> e{ vector3f(0.3f, -1.2f, 2.5f), vector3f(1.0f, 0.0f, 0.0f), vector3f(0.0f, 0.0f, 0.0f) };
+    vector_stream<float, 3> se(e.begin(), e.end());
+    std::vector<quaternionf> q{ quaternionf::identity, quaternionf(0.0f, 1.0f, 0.0f, 0.0f), quaternionf::identity };
+    quaternion_stream<float> sq(q.begin(), q.end());
+
+    quaternion_stream<float> out_q;
+    quat_from_euler_yxz(se, out_q);
+    kismet::test::check_zero_padding(out_q);
+
+    matrix_batch<float, 3, 3> m3;
+    matrix_batch<float, 4, 4> m4;
+    euler_yxz_to_matrix(se, m3);
+    euler_yxz_to_matrix(se, m4);
+    kismet::test::check_zero_padding(m3);
+    kismet::test::check_zero_padding(m4);
+
+    matrix_rotate(sq, m3);
+    matrix_rotate(sq, m4);
+    kismet::test::check_zero_padding(m3);
+    kismet::test::check_zero_padding(m4);
+
+    matrix_to_quat(m3, out_q);
+    kismet::test::check_zero_padding(out_q);
+    matrix_to_quat(m4, out_q);
+    kismet::test::check_zero_padding(out_q);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
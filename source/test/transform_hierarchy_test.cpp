@@ -0,0 +1,117 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/transform.h"
+#include "kismet/math/transform_hierarchy.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+transformd random_transform(std::mt19937& mt)
+{
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    quaterniond q(dis(mt), dis(mt), dis(mt), dis(mt));
+    q.normalize();
+    vector3d s(dis(mt) + 2.0, dis(mt) + 2.0, dis(mt) + 2.0);
+    return transformd(vector3d(dis(mt), dis(mt), dis(mt)), q, s);
+}
+
+// a forest with several roots, the parent of node i is a random earlier node
+transform_hierarchy<double> random_hierarchy(std::size_t n, std::mt19937& mt)
+{
+    transform_hierarchy<double> h;
+    h.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::size_t parent = transform_hierarchy<double>::no_parent;
+        if (i % 50 != 0)
+        {
+            parent = std::uniform_int_distribution<std::size_t>(i / 50 * 50, i - 1)(mt);
+        }
+        h.add(parent, random_transform(mt));
+    }
+    return h;
+}
+
+// the world matrix by walking up to the root
+matrix44<double> world_of(transform_hierarchy<double> const& h, std::size_t i)
+{
+    matrix44<double> m = h.local(i);
+    for (std::size_t p = h.parent(i); p != transform_hierarchy<double>::no_parent; p = h.parent(p))
+    {
+        m = h.local(p) * m;
+    }
+    return m;
+}
+
+void check_world(transform_hierarchy<double> const& h)
+{
+    for (std::size_t i = 0; i < h.size(); ++i)
+    {
+        matrix44<double> exp_m = world_of(h, i);
+        for (std::size_t k = 0; k < 16; ++k)
+        {
+            BOOST_CHECK(approx(h.world(i).data()[k], exp_m.data()[k], 1e-9));
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(transform_hierarchy_test)
+
+BOOST_AUTO_TEST_CASE(transform_hierarchy_update)
+{
+    std::mt19937 mt;
+    auto h = random_hierarchy(200, mt);
+    h.update();
+    check_world(h);
+
+    // nothing changed
+    h.update();
+    for (std::size_t i = 0; i < h.size(); ++i)
+    {
+        BOOST_CHECK(!h.world_changed(i));
+    }
+
+    // only the subtree of node 3 changes
+    h.set_local(3, random_transform(mt));
+    h.update();
+    check_world(h);
+    for (std::size_t i = 0; i < h.size(); ++i)
+    {
+        bool in_subtree = false;
+        for (std::size_t p = i; p != transform_hierarchy<double>::no_parent; p = h.parent(p))
+        {
+            in_subtree = in_subtree || p == 3;
+        }
+        BOOST_CHECK_EQUAL(h.world_changed(i), in_subtree);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transform_hierarchy_parallel_update)
+{
+    std::mt19937 mt;
+    auto h = random_hierarchy(500, mt);
+    h.update(true);
+    check_world(h);
+
+    h.set_local(0, random_transform(mt));
+    h.set_local(120, random_transform(mt));
+    h.set_local(499, random_transform(mt));
+    h.update(true);
+    check_world(h);
+
+    // adding nodes regroups the subtrees
+    h.add(7, random_transform(mt));
+    h.add(transform_hierarchy<double>::no_parent, random_transform(mt));
+    h.update(true);
+    check_world(h);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <boost/test/unit_test.hpp>
 
 #include "kismet/math/matrix.h"
@@ -22,4 +23,160 @@ BOOST_AUTO_TEST_CASE(matrix_to_quaternion)
     KISMET_CHECK_APPROX_COLLECTIONS(res, quaternionf::identity);
 }
 
+namespace
+{
+
+void check_approx(matrix44<float> const& a, matrix44<float> const& b)
+{
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        BOOST_CHECK(approx(a.data()[i], b.data()[i], 1e-5f));
+    }
+}
+
+matrix44<float> make_trs(float sx, float sy, float sz)
+{
+    vector3f axis(1.0f, 2.0f, -0.5f);
+    axis.normalize();
+    quaternionf q(axis, 0.7f);
+    return matrix_translate(1.5f, -2.0f, 3.0f) * matrix_rotate(q) * matrix_scale(sx, sy, sz);
+}
+
+void check_approx(vector3f const& v, vector3f const& exp_v)
+{
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(approx(v[i], exp_v[i], 1e-5f));
+    }
+}
+
+vector3f apply(matrix44<float> const& m, vector3f const& p, float w)
+{
+    vector4f r = m * vector4f(p.x(), p.y(), p.z(), w);
+    return vector3f(r.x(), r.y(), r.z());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(matrix_multiply_affine)
+{
+    matrix44<float> a = make_trs(1.0f, 2.0f, 0.5f);
+    matrix44<float> b = matrix_rotate(quaternionf(vector3f(0.0f, 1.0f, 0.0f), 1.2f)) * matrix_translate(-1.0f, 4.0f, 2.0f);
+    check_approx(multiply_affine(a, b), a * b);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_invert_affine)
+{
+    matrix44<float> rigid = make_trs(1.0f, 1.0f, 1.0f);
+    check_approx(invert_rigid(rigid), invert(rigid));
+
+    matrix44<float> trs = make_trs(2.0f, 0.5f, 3.0f);
+    check_approx(invert_trs(trs), invert(trs));
+    check_approx(invert_affine(trs), invert(trs));
+
+    // shear is affine but not TRS
+    matrix44<float> shear = matrix44<float>::identity;
+    shear[0][1] = 0.5f;
+    matrix44<float> affine = multiply_affine(trs, shear);
+    check_approx(invert_affine(affine), invert(affine));
+
+    // in place
+    matrix44<float> in_place = affine;
+    BOOST_CHECK(invert_affine(in_place, in_place));
+    check_approx(in_place, invert(affine));
+
+    matrix44<float> inverse;
+    BOOST_CHECK(!invert_affine(make_trs(1.0f, 0.0f, 1.0f), inverse));
+}
+
+BOOST_AUTO_TEST_CASE(matrix_extract_sr)
+{
+    vector3f axis(1.0f, 2.0f, -0.5f);
+    axis.normalize();
+    quaternionf exp_q(axis, 0.7f);
+
+    vector3f s;
+    quaternionf q;
+    extract_sr(make_trs(2.0f, 0.5f, 3.0f), s, q);
+    check_approx(s, vector3f(2.0f, 0.5f, 3.0f));
+    check_approx(matrix_rotate(q), matrix_rotate(exp_q));
+
+    // a reflection moves the negative scale to the smallest one
+    matrix44<float> reflection = make_trs(2.0f, 0.5f, -3.0f);
+    extract_sr(reflection, s, q);
+    BOOST_CHECK(approx(mag(q), 1.0f, 1e-5f));
+    check_approx(s, vector3f(2.0f, -0.5f, 3.0f));
+    check_approx(matrix_rotate(q) * matrix_scale(s.x(), s.y(), s.z()),
+                 multiply_affine(matrix_translate(-1.5f, 2.0f, -3.0f), reflection));
+
+    // with shear R^T*M is the symmetric stretch
+    matrix44<float> shear = matrix44<float>::identity;
+    shear[0][1] = 0.5f;
+    matrix44<float> affine = multiply_affine(make_trs(2.0f, 0.5f, 3.0f), shear);
+    extract_sr(affine, s, q);
+    BOOST_CHECK(approx(mag(q), 1.0f, 1e-5f));
+    matrix44<float> stretch = transpose(matrix_rotate(q)) * affine;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(approx(stretch[i][i], s[i], 1e-5f));
+        for (std::size_t j = 0; j < i; ++j)
+        {
+            BOOST_CHECK(approx(stretch[i][j], stretch[j][i], 1e-5f));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trs_transform)
+{
+    vector3f axis(1.0f, 2.0f, -0.5f);
+    axis.normalize();
+    transformf t(vector3f(1.5f, -2.0f, 3.0f), quaternionf(axis, 0.7f), vector3f(2.0f, 0.5f, 3.0f));
+    check_approx(t.matrix(), make_trs(2.0f, 0.5f, 3.0f));
+
+    vector3f p(0.3f, 4.0f, -1.0f);
+    check_approx(t.transform_point(p), apply(t.matrix(), p, 1.0f));
+    check_approx(t.transform_vector(p), apply(t.matrix(), p, 0.0f));
+
+    // the cached matrix follows the changes
+    check_approx(t.cached_matrix(), make_trs(2.0f, 0.5f, 3.0f));
+    t.set_scale(vector3f(1.0f, 1.0f, 1.0f));
+    check_approx(t.cached_matrix(), make_trs(1.0f, 1.0f, 1.0f));
+    t.set_translation(vector3f(0.0f, 0.0f, 0.0f));
+    t.set_rotation(quaternionf::identity);
+    check_approx(t.cached_matrix(), matrix44<float>::identity);
+
+    // matrix is calculated while the cache is out of date
+    t.set_scale(vector3f(2.0f, 0.5f, 3.0f));
+    check_approx(t.matrix(), matrix_scale(2.0f, 0.5f, 3.0f));
+    check_approx(t.cached_matrix(), t.matrix());
+
+    check_approx(transformf().matrix(), matrix44<float>::identity);
+}
+
+BOOST_AUTO_TEST_CASE(trs_transform_compose_invert)
+{
+    vector3f axis(1.0f, 2.0f, -0.5f);
+    axis.normalize();
+    transformf a(vector3f(1.5f, -2.0f, 3.0f), quaternionf(axis, 0.7f), vector3f(2.0f, 2.0f, 2.0f));
+    transformf b(vector3f(-1.0f, 4.0f, 2.0f), quaternionf(vector3f(0.0f, 1.0f, 0.0f), 1.2f), vector3f(1.0f, 0.5f, 3.0f));
+
+    // exact as the scale of a is uniform
+    transformf ab = a * b;
+    check_approx(ab.matrix(), a.matrix() * b.matrix());
+
+    vector3f p(0.3f, 4.0f, -1.0f);
+    check_approx(ab.transform_point(p), a.transform_point(b.transform_point(p)));
+
+    check_approx(invert(a).matrix(), invert(a.matrix()));
+    check_approx(invert(a).transform_point(a.transform_point(p)), p);
+
+    // the inverse of a non uniform scale is only exact for the scale itself
+    transformf s(vector3f(0.0f, 0.0f, 0.0f), quaternionf::identity, vector3f(1.0f, 0.5f, 3.0f));
+    check_approx(invert(s).matrix(), invert(s.matrix()));
+
+    transformf inverse;
+    b.set_scale(vector3f(1.0f, 0.0f, 1.0f));
+    BOOST_CHECK(!invert(b, inverse));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,8 @@
 #include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
 #include "kismet/is_comparable.h"
+#include "kismet/utility.h"
 using namespace kismet;
 
 BOOST_AUTO_TEST_SUITE(utility_test)
@@ -12,4 +15,27 @@ BOOST_AUTO_TEST_CASE(is_comparable_test)
     BOOST_CHECK((is_comparable<int, int>::value));
 }
 
+BOOST_AUTO_TEST_CASE(reorder_test)
+{
+    std::vector<int> v{ 10, 11, 12, 13, 14, 15 };
+    std::size_t indices[] = { 3, 0, 4, 1, 2, 5 };
+    reorder(v.begin(), v.end(), indices);
+
+    std::vector<int> exp_v{ 13, 10, 14, 11, 12, 15 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(v.begin(), v.end(), exp_v.begin(), exp_v.end());
+}
+
+BOOST_AUTO_TEST_CASE(apply_permutation_test)
+{
+    std::vector<int> a{ 0, 1, 2, 3 };
+    std::vector<std::string> b{ "a", "b", "c", "d" };
+    int indices[] = { 2, 3, 1, 0 };
+    apply_permutation(indices, indices + 4, a.begin(), b.begin());
+
+    std::vector<int> exp_a{ 2, 3, 1, 0 };
+    std::vector<std::string> exp_b{ "c", "d", "b", "a" };
+    BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), exp_a.begin(), exp_a.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(b.begin(), b.end(), exp_b.begin(), exp_b.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "kismet/math/vector.h"
+#include "kismet/math/vector_stream.h"
+#include "test/utility.h"
+
+using namespace kismet::math;
+
+namespace
+{
+
+// not a multiple of the SIMD lanes
+const std::size_t stream_size = 37;
+
+std::vector<vector3f> random_vectors(std::mt19937& mt)
+{
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    std::vector<vector3f> v(stream_size);
+    for (auto& e : v)
+    {
+        e = vector3f(dis(mt), dis(mt), dis(mt));
+    }
+    return v;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(vector_stream_test)
+
+BOOST_AUTO_TEST_CASE(vector_stream_aos_conversion)
+{
+    std::mt19937 mt;
+    auto v = random_vectors(mt);
+
+    vector_stream<float, 3> s(v.begin(), v.end());
+    BOOST_CHECK_EQUAL(s.size(), stream_size);
+    BOOST_CHECK_EQUAL(s.stride() % detail::soa_lanes<float>::value, 0u);
+    BOOST_CHECK_EQUAL(s.component(1)[5], v[5].y());
+
+    std::vector<vector3f> out(stream_size);
+    s.copy_to(out.begin());
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_EQUAL_COLLECTIONS(out[k], v[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vector_stream_dot_cross_reflect)
+{
+    std::mt19937 mt;
+    auto a = random_vectors(mt);
+    auto b = random_vectors(mt);
+    for (auto& e : b)
+    {
+        e.normalize();
+    }
+
+    vector_stream<float, 3> sa(a.begin(), a.end());
+    vector_stream<float, 3> sb(b.begin(), b.end());
+
+    float d[stream_size];
+    dot(sa, sb, d);
+
+    vector_stream<float, 3> c;
+    cross(sa, sb, c);
+
+    vector_stream<float, 3> r;
+    reflect(sa, sb, r);
+
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        BOOST_CHECK(approx(d[k], dot(a[k], b[k])));
+        KISMET_CHECK_APPROX_COLLECTIONS(c.get(k), cross(a[k], b[k]));
+        KISMET_CHECK_APPROX_COLLECTIONS(r.get(k), reflect(a[k], b[k]));
+    }
+
+    // the padding stays zero
+    BOOST_CHECK_EQUAL(c.component(0)[stream_size], 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(vector_stream_normalize)
+{
+    std::mt19937 mt;
+    auto v = random_vectors(mt);
+    v[20] = vector3f(0.0f, 0.0f, 0.0f);
+
+    vector_stream<float, 3> s(v.begin(), v.end());
+
+    bool ok[stream_size];
+    BOOST_CHECK(!normalize(s, s, ok));
+
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        BOOST_CHECK_EQUAL(ok[k], k != 20);
+        if (k != 20)
+        {
+            KISMET_CHECK_APPROX_COLLECTIONS(s.get(k), normalize(v[k]));
+        }
+    }
+    KISMET_CHECK_EQUAL_COLLECTIONS(s.get(20), v[20]);
+
+    v.pop_back();
+    v[20] = vector3f(1.0f, 0.0f, 0.0f);
+    vector_stream<float, 3> s2(v.begin(), v.end());
+    BOOST_CHECK(normalize(s2, s2));
+}
+
+BOOST_AUTO_TEST_CASE(vector_stream_lerp)
+{
+    std::mt19937 mt;
+    auto a = random_vectors(mt);
+    auto b = random_vectors(mt);
+
+    vector_stream<float, 3> sa(a.begin(), a.end());
+    vector_stream<float, 3> sb(b.begin(), b.end());
+
+    vector_stream<float, 3> out;
+    lerp(sa, sb, 0.25f, out);
+
+    float t[stream_size];
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::generate(std::begin(t), std::end(t), [&] { return dis(mt); });
+
+    vector_stream<float, 3> out2;
+    lerp(sa, sb, t, out2);
+
+    for (std::size_t k = 0; k < stream_size; ++k)
+    {
+        KISMET_CHECK_APPROX_COLLECTIONS(out.get(k), lerp(a[k], b[k], 0.25f));
+        KISMET_CHECK_APPROX_COLLECTIONS(out2.get(k), lerp(a[k], b[k], t[k]));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()